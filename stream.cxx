@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
-#include "Utils/Stream.hpp"
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <set>
+#include <sstream>
+#include "stream.h"
 
 TEST(Stream, CreateStreamRangeInt)
 {
@@ -17,6 +23,45 @@ TEST(Stream, CreateStreamFromIterable)
     EXPECT_EQ(Result, Vector);
 }
 
+TEST(Stream, CreateStreamBorrowsLvalue)
+{
+    const auto Vector = std::vector{1, 2, 3};
+    const auto Borrowed = Stream::of(Vector);
+
+    EXPECT_EQ(Borrowed.View.data(), Vector.data());
+}
+
+TEST(Stream, CreateStreamOwnsRvalue)
+{
+    auto MakeEvens = []
+    {
+        return Stream::of(std::vector{1, 2, 3, 4, 5, 6})
+            .Filter([](int Value){ return Value % 2 == 0; });
+    };
+
+    const auto Expected = std::vector{2, 4, 6};
+    EXPECT_EQ(MakeEvens().Collect(), Expected);
+}
+
+TEST(Stream, StagesOnNamedStreams)
+{
+    // A named stream stays usable after a stage, which works on a copy of its view
+    const auto Vector = std::vector{1, 2, 3, 4};
+    auto Borrowed = Stream::of(Vector);
+    EXPECT_EQ(Borrowed.Map([](int Value){ return Value * 2; }).Collect(), (std::vector{2, 4, 6, 8}));
+    EXPECT_EQ(Borrowed.Take(2).Collect(), (std::vector{1, 2}));
+
+    auto Materialized = StreamImpl<std::vector<int>>{{5, 6, 7}};
+    EXPECT_EQ(Materialized.Filter([](int Value){ return Value != 6; }).Collect(), (std::vector{5, 7}));
+    EXPECT_EQ(Materialized.View, (std::vector{5, 6, 7}));
+
+    // Owning views can't be copied, so their stages need the stream moved in
+    auto Owned = Stream::of(std::vector{1, 2, 3});
+    constexpr auto CanTake = [](auto& Source){ return requires { Source.Take(1); }; };
+    static_assert(!CanTake(Owned));
+    EXPECT_EQ(std::move(Owned).Take(2).Collect(), (std::vector{1, 2}));
+}
+
 TEST(Stream, Map)
 {
     const auto Expected = std::vector{4, 16, 36, 64, 100};
@@ -37,6 +82,85 @@ TEST(Stream, Reduce)
     EXPECT_EQ(Result[0], 15);
 }
 
+TEST(Stream, ReduceLazy)
+{
+    auto Calls = 0;
+    auto Pipeline = Stream::range(1, 5)
+        .ReduceLazy(0, [&Calls](int Acc, int Value){ ++Calls; return Acc + Value; });
+
+    EXPECT_EQ(Calls, 0);
+    EXPECT_EQ(Pipeline.Collect()[0], 15);
+    EXPECT_EQ(Pipeline.Count(), 1);
+    EXPECT_EQ(Calls, 5);
+}
+
+TEST(Stream, Cache)
+{
+    auto Calls = 0;
+    auto Cached = Stream::range(1, 5)
+        .Map([&Calls](int Value){ ++Calls; return Value * 10; })
+        .Cache();
+
+    EXPECT_EQ(Calls, 0);
+    EXPECT_EQ(Cached.Count(), 5);
+    EXPECT_EQ(Cached.Collect(), (std::vector{10, 20, 30, 40, 50}));
+    EXPECT_EQ(Cached.Max(), 50);
+    EXPECT_EQ(Calls, 5);
+
+    auto Chunked = Stream::range(1, 1000).Filter([](int Value){ return Value % 7 == 0; }).Cache<std::deque>();
+    EXPECT_EQ(Chunked.Count(), 142);
+    EXPECT_EQ(Chunked.Sum(), 71071);
+
+    auto Arena = Stream::Arena<1024>{};
+    auto InArena = Stream::range(1, 8).Cache(Arena);
+    EXPECT_EQ(InArena.Sum(), 36);
+}
+
+namespace
+{
+    // Built from runtime options, yet always the same type, so it can be declared and defined apart
+    Stream::AnyStream<int> Configured(bool Evens, int Limit)
+    {
+        auto Result = Stream::range(1, 100).Erase();
+        if (Evens)
+            Result = std::move(Result).Filter([](int Value){ return Value % 2 == 0; }).Erase();
+
+        return std::move(Result).Take(Limit).Erase();
+    }
+}
+
+TEST(Stream, Erase)
+{
+    EXPECT_EQ(Configured(true, 3).Collect(), (std::vector{2, 4, 6}));
+    EXPECT_EQ(Configured(false, 3).Collect(), (std::vector{1, 2, 3}));
+
+    // Short pipelines are stored inline; ones too large for the buffer go to the heap
+    auto Short = Stream::range(1, 1000).Map([](int Value){ return Value * 2; }).Erase();
+    EXPECT_TRUE(Short.View.IsInline());
+
+    auto Table = std::array<int, 64>{};
+    auto Large = Stream::of(std::views::iota(0, 3000)).Map([Table](int Value){ return Value + Table[0]; }).Erase<long>();
+    EXPECT_FALSE(Large.View.IsInline());
+
+    // Moves keep both working, and each pass restarts the wrapped pipeline across several batches
+    auto Moved = std::move(Short);
+    EXPECT_EQ(Moved.Sum(), 1001000);
+    EXPECT_EQ(Moved.Count(), 1000);
+    auto MovedLarge = std::move(Large);
+    EXPECT_EQ(MovedLarge.Sum(), 4498500);
+    EXPECT_TRUE(Stream::AnyStream<int>{}.Collect().empty());
+}
+
+TEST(Stream, Scan)
+{
+    const auto Expected = std::vector{1, 3, 6, 10, 15};
+    const auto Result = Stream::range(1, 5)
+        .Scan(0, [](int Acc, int Value){ return Acc + Value; })
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+}
+
 TEST(Stream, Each)
 {
     auto Result = 0;
@@ -47,6 +171,34 @@ TEST(Stream, Each)
     EXPECT_EQ(Result, 15);
 }
 
+TEST(Stream, ForEach)
+{
+    const auto Counter = Stream::range(1, 10)
+        .Filter([](int Value){ return Value % 3 == 0; })
+        .ForEach(Stream::counter());
+    EXPECT_EQ(Counter.Count, 3u);
+
+    auto Output = std::vector<int>{};
+    Stream::range(1, 5).Map([](int Value){ return Value * Value; }).ForEach(Stream::to(std::back_inserter(Output)));
+    EXPECT_EQ(Output, (std::vector{1, 4, 9, 16, 25}));
+
+    // Sinks returning false stop the stream
+    auto Seen = 0;
+    Stream::range(1, 100).Each([&Seen](int){ ++Seen; }).ForEach([](int Value){ return Value < 4; });
+    EXPECT_EQ(Seen, 4);
+}
+
+TEST(Stream, ForEachBatchTee)
+{
+    auto Batches = std::vector<std::vector<int>>{};
+    auto Tee = Stream::range(1, 7).ForEach(Stream::tee(
+        Stream::counter(),
+        Stream::batch<int>(3, [&Batches](std::span<const int> Batch){ Batches.emplace_back(Batch.begin(), Batch.end()); })));
+
+    EXPECT_EQ(std::get<0>(Tee.Sinks).Count, 7u);
+    EXPECT_EQ(Batches, (std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7}}));
+}
+
 TEST(Stream, Filter)
 {
     const auto Expected = std::vector{2, 4};
@@ -69,6 +221,88 @@ TEST(Stream, Reject)
     EXPECT_EQ(Result, Expected);
 }
 
+TEST(Stream, Fuse)
+{
+    auto Calls = 0;
+    const auto Expected = std::vector{7, 13, 19};
+    const auto Result = Stream::range(1, 10)
+        .Fuse()
+        .Filter([&Calls](int Value){ ++Calls; return Value % 2 == 0; })
+        .Map([](int Value){ return Value * 3 + 1; })
+        .Reject([](int Value){ return Value > 20; })
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+    EXPECT_EQ(Calls, 10);
+
+    const auto Sum = Stream::range(1, 10).Fuse().Filter([](int Value){ return Value % 2 == 0; }).Reduce(0, std::plus{}).Collect();
+    EXPECT_EQ(Sum, std::vector{30});
+    EXPECT_EQ(Stream::range(1, 10).Fuse().Map([](int Value){ return Value * 2; }).Count(), 10);
+    EXPECT_TRUE(Stream::range(1, 10).Fuse().Map([](int Value){ return Value * 2; }).Any([](int Value){ return Value == 8; }));
+    EXPECT_TRUE(Stream::range(1, 10).Fuse().Filter([](int Value){ return Value > 3; }).All([](int Value){ return Value > 3; }));
+}
+
+TEST(Stream, FuseMinMax)
+{
+    // A fused chain is input-only, and Min/Max fold it in a single pass
+    const auto Fused = [] { return Stream::range(1, 10).Fuse().Filter([](int Value){ return Value % 3 != 0; }).Map([](int Value){ return 20 - Value; }); };
+    EXPECT_EQ(Fused().Min(), 10);
+    EXPECT_EQ(Fused().Max(), 19);
+    EXPECT_EQ(Fused().MinMax(), std::pair(10, 19));
+    EXPECT_FALSE(Stream::range(1, 10).Fuse().Filter([](int Value){ return Value > 10; }).Min());
+}
+
+TEST(Stream, FuseStopsEarly)
+{
+    auto Calls = 0;
+    const auto Found = Stream::range(1, 100)
+        .Fuse()
+        .Each([&Calls](int){ ++Calls; })
+        .Any([](int Value){ return Value == 5; });
+
+    EXPECT_TRUE(Found);
+    EXPECT_EQ(Calls, 5);
+
+    // Pull-only stages still iterate the fused chain one output at a time
+    const auto Expected = std::vector{4, 8};
+    const auto Result = Stream::range(1, 10)
+        .Fuse()
+        .Filter([](int Value){ return Value % 2 == 0; })
+        .Map([](int Value){ return Value * 2; })
+        .Take(2)
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, FilterBatch)
+{
+    auto Values = std::vector<int>(3000);
+    std::iota(Values.begin(), Values.end(), 0);
+
+    auto Expected = std::vector<int>{};
+    for (auto Value : Values)
+    {
+        if (Value % 2 == 0 && Value % 3 == 0)
+            Expected.push_back(Value);
+    }
+
+    // Blocks of 7 leave a partial last block; the second predicate narrows the first one's selection
+    const auto Result = Stream::of(Values)
+        .FilterBatch([](int Value){ return Value % 2 == 0; }, 7)
+        .FilterBatch([](int Value){ return Value % 3 == 0; })
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+    EXPECT_EQ(Stream::of(Values).FilterBatch([](int Value){ return Value < 1500; }).Count(), 1500);
+    EXPECT_EQ(Stream::of(Values).FilterBatch([](int Value){ return Value % 2 == 0; }).Sum(), 2248500);
+    EXPECT_EQ(Stream::of(Values).FilterBatch([](int Value){ return Value > 2990; }).Take(3).Collect(), (std::vector{2991, 2992, 2993}));
+    EXPECT_TRUE(Stream::of(Values).FilterBatch([](int){ return false; }).Collect().empty());
+
+    // Views that aren't contiguous use the regular Filter
+    EXPECT_EQ(Stream::range(0, 10).FilterBatch([](int Value){ return Value % 4 == 0; }).Collect(), (std::vector{0, 4, 8}));
+}
+
 TEST(Stream, Take)
 {
     const auto Expected = std::vector{1, 2};
@@ -88,6 +322,29 @@ TEST(Stream, SplitBy)
         .Collect();
 }
 
+TEST(Stream, SplitByChar)
+{
+    const auto Text = std::string("a,bb,,ccc,");
+    const auto Expected = std::vector<std::string_view>{"a", "bb", "", "ccc", ""};
+    const auto Result = Stream::of(Text)
+        .SplitBy(',')
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, SplitByDelimiter)
+{
+    const auto Text = std::string("key=1\r\nvalue=22\r\n\r\nend");
+    const auto Expected = std::vector<std::string_view>{"key=1", "value=22", "", "end"};
+    const auto Result = Stream::of(Text)
+        .SplitBy(std::string_view("\r\n"))
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+    EXPECT_EQ(Stream::of(std::string()).SplitBy(',').Count(), 0);
+}
+
 TEST(Stream, Join)
 {
     const auto Expected = std::vector{1, 2, 2, 3, 3, 4};
@@ -115,6 +372,44 @@ TEST(Stream, Any)
     EXPECT_EQ(Result, true);
 }
 
+TEST(Stream, AnyStopsAtFirstMatch)
+{
+    auto Calls = 0;
+    const auto Result = Stream::range(1, 1000)
+        .Any([&Calls](int Value){ ++Calls; return Value == 3; });
+
+    EXPECT_EQ(Result, true);
+    EXPECT_EQ(Calls, 3);
+}
+
+TEST(Stream, None)
+{
+    const auto Result = Stream::range(1, 5)
+        .None([](int Value){ return Value > 5; });
+
+    EXPECT_EQ(Result, true);
+}
+
+TEST(Stream, Find)
+{
+    const auto Result = Stream::range(1, 5)
+        .Map([](int Value){ return Value * 2; })
+        .Find([](int Value){ return Value > 5; });
+
+    EXPECT_EQ(Result, 6);
+    EXPECT_FALSE(Stream::range(1, 5).Find([](int Value){ return Value > 5; }));
+}
+
+TEST(Stream, FindIndex)
+{
+    const auto Result = Stream::range(1, 5)
+        .Filter([](int Value){ return Value % 2 == 0; })
+        .FindIndex([](int Value){ return Value == 4; });
+
+    EXPECT_EQ(Result, 1);
+    EXPECT_FALSE(Stream::range(1, 5).FindIndex([](int Value){ return Value > 5; }));
+}
+
 TEST(Stream, Uniq)
 {
     const auto Vector = std::vector{1, 2, 1, 3, 4, 5, 1, 6, 7};
@@ -126,6 +421,44 @@ TEST(Stream, Uniq)
     EXPECT_EQ(Result, Expected);
 }
 
+TEST(Stream, UniqMinMax)
+{
+    // Uniq is single-pass, so terminals after it must not need a forward range
+    const auto Vector = std::vector{4, 2, 4, 9, 2, 7};
+    EXPECT_EQ(Stream::of(Vector).Uniq().Min(), 2);
+    EXPECT_EQ(Stream::of(Vector).Uniq().Max(), 9);
+    EXPECT_EQ(Stream::of(Vector).Uniq().MinMax(), std::pair(2, 9));
+}
+
+TEST(Stream, UniqBy)
+{
+    const auto Vector = std::vector{1, 2, 3, 4, 5, 6, 7};
+    const auto Expected = std::vector{1, 2, 3};
+    const auto Result = Stream::of(Vector)
+        .UniqBy([](int Value){ return Value % 3; }, 3)
+        .Collect();
+
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, UniqOrderedOnly)
+{
+    struct Point
+    {
+        int X;
+        int Y;
+        auto operator<=>(const Point&) const = default;
+    };
+
+    const auto Vector = std::vector{Point{1, 2}, Point{3, 4}, Point{1, 2}};
+    const auto Result = Stream::of(Vector)
+        .Uniq()
+        .Collect();
+
+    EXPECT_EQ(Result.size(), 2);
+    EXPECT_EQ(Result[1], (Point{3, 4}));
+}
+
 TEST(Stream, WithIndex)
 {
     const auto Result = Stream::range(1, 3)
@@ -136,16 +469,247 @@ TEST(Stream, WithIndex)
     EXPECT_EQ(Result, Expected);
 }
 
+TEST(Stream, WithIndexAfterFilter)
+{
+    const auto Result = Stream::range(1, 6)
+        .Filter([](int Value){ return Value % 2 == 0; })
+        .WithIndex(1)
+        .Collect();
+
+    const auto Expected = std::vector{std::pair(1, 2), std::pair(2, 4), std::pair(3, 6)};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, Zip)
+{
+    const auto Names = std::vector<std::string>{"a", "b", "c"};
+    const auto Scores = std::list{10, 20, 30, 40};
+
+    const auto Result = Stream::range(1, 10)
+        .Zip(Names, Scores)
+        .Map([](const auto& Row){ return std::get<1>(Row) + std::to_string(std::get<0>(Row) * std::get<2>(Row)); })
+        .Collect();
+    EXPECT_EQ(Result, (std::vector<std::string>{"a10", "b40", "c90"}));
+
+    // Random access, sized inputs keep both, so the zip can be split across threads
+    auto Left = std::vector<std::int64_t>(10000, 2);
+    auto Right = std::vector<std::int64_t>(10000, 3);
+    auto Dot = Stream::of(Left).ZipWith([](auto A, auto B){ return A * B; }, Stream::of(Right));
+    static_assert(std::ranges::random_access_range<decltype(Dot.View)> && std::ranges::sized_range<decltype(Dot.View)>);
+    EXPECT_EQ(Dot.View.size(), 10000);
+    EXPECT_EQ(Dot.Par(4).Sum(), 60000);
+
+    // Stored elements are tuples of values, so sorting or collecting leaves the sources alone
+    auto Keys = std::vector{3, 1, 2};
+    auto Values = std::vector<std::string>{"c", "a", "b"};
+    const auto Sorted = Stream::of(Keys).Zip(Values).Sort([](const auto& A, const auto& B){ return std::get<0>(A) < std::get<0>(B); }).Collect();
+    EXPECT_EQ(Sorted, (std::vector<std::tuple<int, std::string>>{{1, "a"}, {2, "b"}, {3, "c"}}));
+    EXPECT_EQ(Keys, (std::vector{3, 1, 2}));
+    EXPECT_EQ(Values, (std::vector<std::string>{"c", "a", "b"}));
+    EXPECT_EQ(Stream::of(Keys).Zip(Values).TopK(1), (std::vector<std::tuple<int, std::string>>{{3, "c"}}));
+}
+
+TEST(Stream, Concat)
+{
+    const auto Tail = std::list{7, 8};
+    auto Joined = Stream::range(1, 3).Concat(std::vector<int>{}, Stream::range(4, 6), Tail);
+
+    EXPECT_EQ(Joined.View.size(), 8);
+    EXPECT_EQ(Stream::range(1, 3).Concat(std::vector<int>{}, Stream::range(4, 6), Tail).Collect(), (std::vector{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(Stream::of(std::vector<int>{}).Concat(std::vector<int>{}).Count(), 0);
+}
+
+TEST(Stream, ConcatRandomAccess)
+{
+    const auto Head = std::vector{5, 3, 1};
+    const auto Tail = std::vector{4, 2};
+    const auto Joined = Stream::of(Head).Concat(std::vector<int>{}, Tail);
+
+    // Random access, sized inputs keep the view random access, and a const stream still iterates
+    static_assert(std::ranges::random_access_range<const decltype(Joined.View)>);
+    EXPECT_TRUE(std::ranges::equal(Joined.View, std::vector{5, 3, 1, 4, 2}));
+    EXPECT_EQ(Joined.View[3], 4);
+    EXPECT_EQ(*(Joined.View.begin() + 4 - 2), 1);
+    EXPECT_EQ(std::ranges::distance(Joined.View), 5);
+    EXPECT_EQ(Stream::of(Head).Concat(Tail).With({.Workers = 2, .Grain = 1}).Sum(), 15);
+}
+
+TEST(Stream, Interleave)
+{
+    const auto Result = Stream::range(1, 3).Interleave(std::vector{10, 20, 30, 40, 50}, Stream::range(100, 100)).Collect();
+    EXPECT_EQ(Result, (std::vector{1, 10, 100, 2, 20, 3, 30, 40, 50}));
+    EXPECT_TRUE(Stream::of(std::vector<int>{}).Interleave(std::vector<int>{}).Collect().empty());
+}
+
+TEST(Stream, InterleaveRandomAccess)
+{
+    const auto Expected = std::vector{1, 10, 100, 2, 20, 3, 30, 40, 50};
+    const auto Interleaved = Stream::range(1, 3).Interleave(std::vector{10, 20, 30, 40, 50}, Stream::range(100, 100));
+
+    static_assert(std::ranges::random_access_range<const decltype(Interleaved.View)>);
+    const auto& View = Interleaved.View;
+    for (std::size_t Index = 0; Index < Expected.size(); ++Index)
+    {
+        EXPECT_EQ(View[static_cast<std::ptrdiff_t>(Index)], Expected[Index]);
+        EXPECT_EQ(std::ranges::next(View.begin(), static_cast<std::ptrdiff_t>(Index)), View.begin() + static_cast<std::ptrdiff_t>(Index));
+    }
+
+    EXPECT_EQ(View.end() - View.begin(), 9);
+    EXPECT_TRUE(View.begin() + 9 == View.end());
+    EXPECT_EQ(*(View.begin() + 8 - 4), 20);
+}
+
 TEST(Stream, Min)
 {
     const auto Result = Stream::range(1, 5).Min();
     EXPECT_EQ(Result, 1);
+    EXPECT_FALSE(Stream::of(std::vector<int>{}).Min());
 }
 
 TEST(Stream, Max)
 {
     const auto Result = Stream::range(1, 5).Max();
     EXPECT_EQ(Result, 5);
+    EXPECT_FALSE(Stream::of(std::vector<int>{}).Max());
+}
+
+TEST(Stream, MinMaxInputOnly)
+{
+    // Input-only views are folded in a single pass
+    auto Input = std::istringstream("pear\napple\nquince\nfig");
+    auto Lines = Stream::lines(Input).Map([](std::string_view Line){ return std::string(Line); });
+    static_assert(!std::ranges::forward_range<decltype(Lines.View)>);
+    EXPECT_EQ(Lines.Min(), "apple");
+
+    auto Again = std::istringstream("pear\napple\nquince\nfig");
+    EXPECT_EQ(Stream::lines(Again).Map([](std::string_view Line){ return std::string(Line); }).Max(), "quince");
+
+    const auto Vector = std::vector{4, 2, 9, 7};
+    EXPECT_EQ(Stream::of(Vector).Erase().Min(), 2);
+    EXPECT_EQ(Stream::of(Vector).FilterBatch([](int Value){ return Value % 2 == 0; }).Max(), 4);
+    EXPECT_FALSE(Stream::of(std::vector<int>{}).Erase().Max());
+}
+
+TEST(Stream, MinMax)
+{
+    const auto Vector = std::vector{3, 1, 4, 1, 5, 9, 2, 6};
+    const auto Result = Stream::of(Vector).MinMax();
+
+    EXPECT_EQ(Result, std::pair(1, 9));
+    EXPECT_FALSE(Stream::of(std::vector<int>{}).MinMax());
+}
+
+TEST(Stream, MinMaxParallelStrings)
+{
+    auto Words = std::vector<std::string>{};
+    for (auto Index = 0; Index < 100; ++Index)
+        Words.push_back(std::string(32, static_cast<char>('b' + Index % 20)) + std::to_string(Index));
+    Words[57] = std::string(32, 'a') + "0";
+    Words[13] = std::string(32, 'z') + "9";
+
+    const auto Result = Stream::of(Words).With({.Workers = 4, .Grain = 1}).MinMax();
+
+    ASSERT_TRUE(Result);
+    EXPECT_EQ(Result->first, std::string(32, 'a') + "0");
+    EXPECT_EQ(Result->second, std::string(32, 'z') + "9");
+}
+
+TEST(Stream, Stats)
+{
+    auto Calls = 0;
+    const auto Result = Stream::range(1, 4)
+        .Map([&Calls](int Value){ ++Calls; return Value * 2; })
+        .Stats();
+
+    ASSERT_TRUE(Result);
+    EXPECT_EQ(Calls, 4);
+    EXPECT_EQ(Result->Count, 4);
+    EXPECT_EQ(Result->Sum, 20);
+    EXPECT_EQ(Result->Min, 2);
+    EXPECT_EQ(Result->Max, 8);
+    EXPECT_DOUBLE_EQ(Result->Mean, 5.0);
+    EXPECT_DOUBLE_EQ(Result->Variance, 5.0);
+
+    const auto Parallel = Stream::range(1, 4).With({.Workers = 2, .Grain = 1}).Map([](int Value){ return Value * 2; }).Stats();
+    EXPECT_DOUBLE_EQ(Parallel->Variance, 5.0);
+    EXPECT_FALSE(Stream::of(std::vector<int>{}).Stats());
+}
+
+TEST(Stream, ApproxCountDistinct)
+{
+    // Each value appears three times; small cardinalities are counted almost exactly
+    const auto Distinct = Stream::range(0, 299999).Map([](int Value){ return Value % 100000; }).ApproxCountDistinct();
+    EXPECT_NEAR(static_cast<double>(Distinct), 100000.0, 5000.0);
+    EXPECT_NEAR(static_cast<double>(Stream::range(1, 50).ApproxCountDistinct()), 50.0, 1.0);
+    EXPECT_EQ(Stream::of(std::vector<int>{}).ApproxCountDistinct(), 0);
+
+    // Sketches of the slices merge into the same estimate as a sequential pass
+    auto Values = Stream::range(0, 299999).Map([](int Value){ return Value % 100000; }).Collect();
+    EXPECT_EQ(Stream::of(Values).Par(4).ApproxCountDistinct(), Stream::of(Values).ApproxCountDistinct());
+}
+
+TEST(Stream, ApproxQuantiles)
+{
+    // A scrambled permutation of 0..99999, so the sketch sees no useful order
+    auto Values = Stream::range(0, 99999).Map([](int Value){ return static_cast<int>(Value * 7919L % 100000); }).Collect();
+
+    const auto Result = Stream::of(Values).ApproxQuantiles({0.0, 0.5, 0.99, 1.0});
+    ASSERT_EQ(Result.size(), 4);
+    EXPECT_EQ(Result[0], 0);
+    EXPECT_NEAR(Result[1], 50000, 2000);
+    EXPECT_NEAR(Result[2], 99000, 2000);
+    EXPECT_EQ(Result[3], 99999);
+
+    const auto Parallel = Stream::of(Values).Par(4).ApproxQuantiles({0.5});
+    EXPECT_NEAR(Parallel[0], 50000, 2000);
+    EXPECT_TRUE(Stream::of(std::vector<int>{}).ApproxQuantiles({0.5}).empty());
+}
+
+TEST(Stream, ApproxTopK)
+{
+    // Three heavy hitters among 10000 values seen once
+    auto Values = std::vector<int>{};
+    for (auto Index = 0; Index < 10000; ++Index)
+    {
+        Values.push_back(1000 + Index);
+        if (Index % 10 == 0) Values.push_back(1);
+        if (Index % 20 == 0) Values.push_back(2);
+        if (Index % 40 == 0) Values.push_back(3);
+    }
+
+    for (auto Policy : {Stream::Sequential, Stream::ExecutionPolicy{.Workers = 4}})
+    {
+        const auto Result = Stream::of(Values).With(Policy).ApproxTopK(3, 64);
+        ASSERT_EQ(Result.size(), 3);
+
+        const auto Expected = std::array{std::pair{1, 1000u}, std::pair{2, 500u}, std::pair{3, 250u}};
+        for (std::size_t Index = 0; Index < Expected.size(); ++Index)
+        {
+            EXPECT_EQ(Result[Index].Value, Expected[Index].first);
+            EXPECT_GE(Result[Index].Count, Expected[Index].second);
+            EXPECT_LE(Result[Index].Count - Result[Index].Error, Expected[Index].second);
+        }
+    }
+}
+
+TEST(Stream, SummarizePrefilled)
+{
+    auto Quantiles = Stream::QuantileSketch<int>{};
+    auto Frequent = Stream::SpaceSaving<int>{4096};
+    for (auto Index = 0; Index < 100; ++Index)
+    {
+        Quantiles.Add(7);
+        Frequent.Add(7);
+    }
+
+    // Each slice starts from an empty sketch, so what was already added is counted once
+    const auto Policy = Stream::ExecutionPolicy{.Workers = 4, .Grain = 1};
+    EXPECT_EQ(Stream::range(100, 1099).With(Policy).Summarize(Quantiles).Count(), 1100);
+
+    const auto Top = Stream::range(100, 1099).With(Policy).Summarize(Frequent).Top(1);
+    ASSERT_EQ(Top.size(), 1);
+    EXPECT_EQ(Top[0].Value, 7);
+    EXPECT_EQ(Top[0].Count, 100);
 }
 
 TEST(Stream, Sum)
@@ -154,6 +718,31 @@ TEST(Stream, Sum)
     EXPECT_EQ(Result, 15);
 }
 
+TEST(Stream, SumUsesElementType)
+{
+    const auto Doubles = std::vector{0.5, 1.25, 2.0};
+    EXPECT_DOUBLE_EQ(Stream::of(Doubles).Sum(), 3.75);
+
+    const auto Large = std::vector{std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+    EXPECT_EQ(Stream::of(Large).Sum(), std::int64_t{std::numeric_limits<int>::max()} * 2);
+    EXPECT_EQ(Stream::of(Large).Sum<double>(), 2.0 * std::numeric_limits<int>::max());
+}
+
+TEST(Stream, SumContiguous)
+{
+    const auto Vector = Stream::range(1, 1001).Map([](int Value){ return static_cast<float>(Value); }).Collect();
+    EXPECT_FLOAT_EQ(Stream::of(Vector).Sum(), 501501.0f);
+}
+
+TEST(Stream, SumCompensated)
+{
+    auto Vector = std::vector<double>(10000, 0.1);
+    Vector.insert(Vector.begin(), 1e16);
+
+    EXPECT_DOUBLE_EQ(Stream::of(Vector).Sum(Stream::Summation::Kahan), 1e16 + 1000.0);
+    EXPECT_NEAR(Stream::of(std::vector<double>(100000, 0.1)).Sum(Stream::Summation::Pairwise), 10000.0, 1e-9);
+}
+
 TEST(Stream, Contains)
 {
     const auto Result = Stream::range(1, 5).Contains(1);
@@ -180,6 +769,270 @@ TEST(Stream, ChunkEvery)
     EXPECT_EQ(Result[2][1], 6);
 }
 
+TEST(Stream, ChunkEveryUneven)
+{
+    const auto List = std::list{1, 2, 3, 4, 5};
+    const auto Result = Stream::of(List)
+        .ChunkEvery(2)
+        .Map([](auto Chunk){ return std::ranges::distance(Chunk); })
+        .Collect();
+
+    const auto Expected = std::vector<std::ptrdiff_t>{2, 2, 1};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, ChunkEveryInfinite)
+{
+    const auto Result = Stream::of(std::views::iota(1))
+        .ChunkEvery(3)
+        .Map([](auto Chunk){ return *Chunk.begin(); })
+        .Take(3)
+        .Collect();
+
+    const auto Expected = std::vector{1, 4, 7};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, ChunkEveryInputRange)
+{
+    auto Input = std::istringstream("a\nb\nc\nd\ne");
+    const auto Result = Stream::lines(Input)
+        .Map([](std::string_view Line){ return std::string(Line); })
+        .ChunkEvery(2)
+        .Collect();
+
+    const auto Expected = std::vector<std::vector<std::string>>{{"a", "b"}, {"c", "d"}, {"e"}};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, ChunkEveryZero)
+{
+    EXPECT_THROW(Stream::range(1, 6).ChunkEvery(0), std::invalid_argument);
+    EXPECT_THROW(Stream::range(1, 6).Window(0), std::invalid_argument);
+}
+
+TEST(Stream, ChunkWhile)
+{
+    const auto Vector = std::vector{1, 2, 3, 1, 2, 0};
+    const auto Result = Stream::of(Vector)
+        .ChunkWhile([](int Left, int Right){ return Left < Right; })
+        .Map([](auto Chunk){ return std::vector(Chunk.begin(), Chunk.end()); })
+        .Collect();
+
+    const auto Expected = std::vector<std::vector<int>>{{1, 2, 3}, {1, 2}, {0}};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, Window)
+{
+    const auto Result = Stream::range(1, 5)
+        .Window(3)
+        .Map([](auto Window){ return std::accumulate(Window.begin(), Window.end(), 0); })
+        .Collect();
+
+    const auto Expected = std::vector{6, 9, 12};
+    EXPECT_EQ(Result, Expected);
+}
+
+TEST(Stream, Tumbling)
+{
+    EXPECT_EQ(Stream::range(1, 7).Tumbling(3, 0, std::plus{}).Collect(), (std::vector{6, 15, 7}));
+
+    // Windows are emitted as they complete, so unbounded sources work
+    const auto Result = Stream::of(std::views::iota(1)).Tumbling(2, 1, std::multiplies{}).Take(3).Collect();
+    EXPECT_EQ(Result, (std::vector{2, 12, 30}));
+}
+
+TEST(Stream, Sliding)
+{
+    EXPECT_EQ(Stream::of(std::vector{3, 1, 4, 1, 5, 9, 2}).Sliding(3, [](int A, int B){ return std::max(A, B); }).Collect(), (std::vector{4, 4, 5, 9, 9}));
+    EXPECT_TRUE(Stream::range(1, 2).Sliding(3, std::plus{}).Collect().empty());
+
+    // Func only needs to be associative: concatenation checks the window is folded oldest first
+    const auto Letters = std::vector<std::string>{"a", "b", "c", "d", "e"};
+    EXPECT_EQ(Stream::of(Letters).Sliding(3, std::plus{}).Collect(), (std::vector<std::string>{"abc", "bcd", "cde"}));
+
+    const auto Sums = Stream::of(std::views::iota(1)).Sliding(4, std::plus{}).Take(3).Collect();
+    EXPECT_EQ(Sums, (std::vector{10, 14, 18}));
+}
+
+TEST(Stream, TumblingBy)
+{
+    struct Event { int Time; int Value; };
+    const auto Events = std::vector<Event>{{0, 1}, {3, 2}, {9, 3}, {10, 4}, {35, 5}, {39, 6}};
+
+    // Windows of 10 aligned to the first event; the empty window [20, 30) is skipped
+    const auto Result = Stream::of(Events).TumblingBy(&Event::Time, 10, 0, [](int Acc, const Event& E){ return Acc + E.Value; }).Collect();
+    EXPECT_EQ(Result, (std::vector{6, 4, 11}));
+
+    using namespace std::chrono_literals;
+    auto Start = std::chrono::steady_clock::time_point{};
+    const auto Times = std::vector{Start, Start + 400ms, Start + 1s, Start + 1500ms, Start + 2100ms};
+    EXPECT_EQ(Stream::of(Times).TumblingBy(std::identity{}, 1s, 0, [](int Acc, auto){ return Acc + 1; }).Collect(), (std::vector{2, 2, 1}));
+
+    // Floating-point times stay on the same grid of whole widths
+    const auto Seconds = std::vector{0.0, 0.5, 1.2, 1.9, 2.1, 2.95, 3.05};
+    EXPECT_EQ(Stream::of(Seconds).TumblingBy(std::identity{}, 1.0, 0, [](int Acc, double){ return Acc + 1; }).Collect(), (std::vector{2, 2, 2, 1}));
+}
+
+TEST(Stream, SlidingBy)
+{
+    struct Event { int Time; int Value; };
+    const auto Events = std::vector<Event>{{0, 1}, {3, 2}, {9, 3}, {10, 4}, {15, 5}, {40, 6}};
+
+    // Sum of the values in the 10 time units ending at each event
+    const auto Result = Stream::of(Events)
+        .SlidingBy(&Event::Time, 10, [](Event Older, Event Newer){ return Event{Newer.Time, Older.Value + Newer.Value}; })
+        .Map(&Event::Value)
+        .Collect();
+    EXPECT_EQ(Result, (std::vector{1, 3, 6, 9, 12, 6}));
+}
+
+TEST(Stream, Sort)
+{
+    const auto Data = std::vector{5, 3, 9, 1, 7};
+    EXPECT_EQ(Stream::of(Data).Sort().Collect(), (std::vector{1, 3, 5, 7, 9}));
+    EXPECT_EQ(Stream::of(Data).Sort(std::greater{}).Take(2).Collect(), (std::vector{9, 7}));
+
+    const auto Words = std::vector<std::string>{"ccc", "a", "bb"};
+    EXPECT_EQ(Stream::of(Words).SortBy([](const std::string& Word){ return Word.size(); }).Collect(), (std::vector<std::string>{"a", "bb", "ccc"}));
+}
+
+TEST(Stream, SortParallel)
+{
+    const auto Data = Stream::range(0, 9999).Map([](int Value){ return (Value * 7919) % 10007; }).Collect();
+    auto Expected = Data;
+    std::sort(Expected.begin(), Expected.end());
+
+    EXPECT_EQ(Stream::of(Data).With({.Workers = 5, .Grain = 64}).Sort().Collect(), Expected);
+}
+
+TEST(Stream, TopK)
+{
+    const auto Data = Stream::range(0, 9999).Map([](int Value){ return (Value * 7919) % 10007; }).Collect();
+    auto Expected = Data;
+    std::sort(Expected.begin(), Expected.end(), std::greater{});
+    Expected.resize(100);
+
+    EXPECT_EQ(Stream::of(Data).TopK(100), Expected);
+    EXPECT_EQ(Stream::of(Data).With({.Workers = 4, .Grain = 64}).TopK(100), Expected);
+    EXPECT_EQ(Stream::range(1, 3).TopK(5), (std::vector{3, 2, 1}));
+    EXPECT_EQ(Stream::range(1, 10).TopK(3, std::less{}), (std::vector{1, 2, 3}));
+}
+
+TEST(Stream, MinByMaxBy)
+{
+    const auto Words = std::vector<std::string>{"pear", "fig", "banana", "kiwi", "apple"};
+    const auto Length = [](const std::string& Word){ return Word.size(); };
+
+    EXPECT_EQ(Stream::of(Words).MinBy(1, Length), (std::vector<std::string>{"fig"}));
+    EXPECT_EQ(Stream::of(Words).MaxBy(2, Length), (std::vector<std::string>{"banana", "apple"}));
+}
+
+TEST(Stream, GroupBy)
+{
+    const auto Groups = Stream::range(1, 10).GroupBy([](int Value){ return Value % 3; });
+
+    EXPECT_EQ(Groups.size(), 3u);
+    EXPECT_EQ(Groups.at(0), (std::vector{3, 6, 9}));
+    EXPECT_EQ(Groups.find(1)->second, (std::vector{1, 4, 7, 10}));
+    EXPECT_FALSE(Groups.contains(3));
+    EXPECT_EQ(Groups.find(3), Groups.end());
+    EXPECT_THROW(Groups.at(3), std::out_of_range);
+    EXPECT_EQ(Groups.begin()->first, 1);
+
+    // Keys without std::hash fall back to an ordered map with the same members
+    const auto Pairs = Stream::range(1, 4).GroupBy([](int Value){ return std::pair{Value % 2, 0}; });
+    EXPECT_EQ(Pairs.size(), 2u);
+    EXPECT_EQ(Pairs.at(std::pair{0, 0}), (std::vector{2, 4}));
+    EXPECT_FALSE(Pairs.contains(std::pair{2, 0}));
+    EXPECT_EQ(Pairs.begin()->second, (std::vector{2, 4}));
+}
+
+TEST(Stream, Frequencies)
+{
+    const auto Words = std::vector<std::string>{"a", "b", "a", "c", "a", "b"};
+    const auto Counts = Stream::of(Words).Frequencies();
+
+    EXPECT_EQ(Counts.at("a"), 3u);
+    EXPECT_EQ(Counts.at("b"), 2u);
+    EXPECT_EQ(Counts.at("c"), 1u);
+}
+
+TEST(Stream, CollectWithCapacityHint)
+{
+    const auto Result = Stream::range(1, 100)
+        .Filter([](int Value){ return Value % 2 == 0; })
+        .Collect(50);
+
+    EXPECT_EQ(Result.size(), 50);
+    EXPECT_EQ(Result.capacity(), 50);
+}
+
+TEST(Stream, CollectInto)
+{
+    const auto Vector = std::vector{3, 1, 3, 2};
+    const auto Expected = std::set{1, 2, 3};
+
+    EXPECT_EQ(Stream::of(Vector).CollectInto<std::set>(), Expected);
+
+    auto Arena = Stream::Arena<256>{};
+    const auto Result = Stream::of(Vector).CollectInto<std::pmr::vector<int>>(&Arena);
+    EXPECT_EQ(Result.size(), 4);
+    EXPECT_EQ(Result.get_allocator().resource(), &Arena);
+}
+
+TEST(Stream, CollectTo)
+{
+    auto Buffer = std::vector{0};
+    Stream::range(1, 3).CollectTo(Buffer);
+    Stream::range(4, 5).CollectTo(Buffer);
+
+    const auto Expected = std::vector{0, 1, 2, 3, 4, 5};
+    EXPECT_EQ(Buffer, Expected);
+}
+
+TEST(Stream, CollectArray)
+{
+    const auto Result = Stream::range(1, 10).Filter([](int Value){ return Value % 3 == 0; }).Collect<3>();
+    EXPECT_EQ(Result, (std::array{3, 6, 9}));
+    EXPECT_THROW(Stream::range(1, 2).Collect<3>(), std::length_error);
+}
+
+// Whole pipelines run in constant evaluation; the vectors they allocate are freed before it ends
+static_assert(Stream::range(1, 4).Map([](int Value){ return Value * Value; }).Reduce(0, std::plus{}).Collect() == std::vector{30});
+static_assert(Stream::range(1, 100).Fuse().Filter([](int Value){ return Value % 7 == 0; }).Count() == 14);
+static_assert(Stream::range(1, 5).Map([](int Value){ return Value * 2; }).Collect<5>() == std::array{2, 4, 6, 8, 10});
+static_assert(Stream::of(std::array{3, 1, 2}).Any([](int Value){ return Value == 2; }));
+static_assert(Stream::of(std::string_view("a,bb,,ccc,")).SplitBy(',').Count() == 5);
+static_assert(Stream::of(std::string_view("key=1\r\nvalue=22\r\n\r\nend")).SplitBy(std::string_view("\r\n")).Map([](std::string_view Piece){ return Piece.size(); }).Collect<4>() == std::array<std::size_t, 4>{5, 8, 0, 3});
+
+namespace
+{
+    constexpr auto Crc32Table = Stream::ct([]
+    {
+        return Stream::range(0u, 255u)
+            .Map([](std::uint32_t Value)
+            {
+                for (auto Bit = 0; Bit < 8; ++Bit)
+                    Value = Value & 1 ? 0xEDB88320u ^ (Value >> 1) : Value >> 1;
+                return Value;
+            })
+            .Collect<256>();
+    });
+}
+
+TEST(Stream, CompileTimeTable)
+{
+    static_assert(Crc32Table[1] == 0x77073096u);
+    static_assert(Crc32Table[255] == 0x2D02EF8Du);
+
+    auto Crc = 0xFFFFFFFFu;
+    for (auto Byte : std::string_view{"123456789"})
+        Crc = Crc32Table[(Crc ^ static_cast<std::uint8_t>(Byte)) & 0xFF] ^ (Crc >> 8);
+    EXPECT_EQ(Crc ^ 0xFFFFFFFFu, 0xCBF43926u);
+}
+
 TEST(Stream, Keys)
 {
     const auto KeyMap = std::vector<std::pair<char,int>>{{'b',3},{'a',4},{'z',2},{'k',9}};
@@ -201,3 +1054,312 @@ TEST(Stream, Values)
     
     EXPECT_EQ(Result, Expected);
 }
+
+TEST(Stream, Columns)
+{
+    const auto Ids = std::vector{1, 2, 3, 4};
+    auto Prices = std::vector{2.5, 1.0, 4.0, 0.5};
+    const auto Names = std::vector<std::string>{"a", "b", "c", "d"};
+
+    const auto Expensive = Stream::columns(Ids, Prices, Names)
+        .Filter([](const auto& Row){ return std::get<1>(Row) > 1.0; })
+        .Map([](const auto& Row){ return std::get<2>(Row); })
+        .Collect();
+    EXPECT_EQ(Expensive, (std::vector<std::string>{"a", "c"}));
+
+    // Rows refer to the columns, so stages can write through them
+    Stream::columns(Ids, Prices).Each([](auto Row){ std::get<1>(Row) *= std::get<0>(Row); }).Run();
+    EXPECT_EQ(Prices, (std::vector{2.5, 2.0, 12.0, 2.0}));
+
+    EXPECT_EQ(Stream::columns(Ids, Prices).With({.Workers = 2, .Grain = 1}).Count(), 4);
+
+    // ...while collected or sorted rows are copies
+    const auto Cheapest = Stream::columns(Prices, Names).Sort().Collect();
+    EXPECT_EQ(Cheapest.front(), (std::tuple{2.0, std::string("b")}));
+    EXPECT_EQ(Prices, (std::vector{2.5, 2.0, 12.0, 2.0}));
+    EXPECT_EQ(Names, (std::vector<std::string>{"a", "b", "c", "d"}));
+
+    const auto Short = std::vector{1};
+    EXPECT_THROW(Stream::columns(Ids, Short), std::invalid_argument);
+}
+
+TEST(Stream, Project)
+{
+    const auto Ids = std::vector{1, 2, 3, 4};
+    const auto Prices = std::vector{2.5, 1.0, 4.0, 0.5};
+    const auto Names = std::vector<std::string>{"a", "b", "c", "d"};
+
+    auto Column = Stream::columns(Ids, Prices, Names).Project<1>();
+    static_assert(std::same_as<decltype(Column.View), std::span<const double>>);
+    EXPECT_DOUBLE_EQ(Column.Sum(), 8.0);
+
+    const auto Pairs = Stream::columns(Ids, Prices, Names)
+        .Project<2, 0>()
+        .Map([](auto Row){ return std::get<0>(Row) + std::to_string(std::get<1>(Row)); })
+        .Collect();
+    EXPECT_EQ(Pairs, (std::vector<std::string>{"a1", "b2", "c3", "d4"}));
+
+    const auto Records = std::vector<std::tuple<int, char, double>>{{1, 'x', 0.5}, {2, 'y', 1.5}};
+    EXPECT_EQ(Stream::of(Records).Project<1>().Collect(), (std::vector{'x', 'y'}));
+    const auto Swapped = Stream::of(Records).Project<2, 0>().Collect();
+    EXPECT_EQ(Swapped, (std::vector<std::tuple<double, int>>{{0.5, 1}, {1.5, 2}}));
+}
+
+TEST(Stream, Parallel)
+{
+    const auto Policy = Stream::ExecutionPolicy{.Workers = 4, .Grain = 16};
+    const auto Expected = Stream::range(1, 1000).Map([](int Value){ return Value * 3; }).Collect();
+    auto Parallel = Stream::range(1, 1000).With(Policy).Map([](int Value){ return Value * 3; });
+
+    EXPECT_EQ(Parallel.Collect(), Expected);
+    EXPECT_EQ(Parallel.Sum(), 1501500);
+    EXPECT_EQ(Parallel.Min(), 3);
+    EXPECT_EQ(Parallel.Max(), 3000);
+    EXPECT_EQ(Parallel.Count(300), 1);
+    EXPECT_EQ(Parallel.Reduce(0, [](int Acc, int Value){ return Acc + Value; }, std::plus{}).Collect()[0], 1501500);
+}
+
+TEST(Stream, ParallelReduceCombine)
+{
+    const auto Policy = Stream::ExecutionPolicy{.Workers = 4, .Grain = 16};
+
+    // Without a combiner the fold stays sequential, so operators that aren't associative keep their result
+    const auto Subtract = [](int Acc, int Value){ return Acc - Value; };
+    EXPECT_EQ(Stream::range(1, 100).With(Policy).Reduce(0, Subtract).Collect()[0], -5050);
+
+    // The accumulator differs from the element type: slices append into their own vectors, then join in order
+    const auto Append = [](std::vector<int> Acc, int Value){ Acc.push_back(Value); return Acc; };
+    const auto Join = [](std::vector<int> Left, const std::vector<int>& Right)
+    {
+        Left.insert(Left.end(), Right.begin(), Right.end());
+        return Left;
+    };
+    EXPECT_EQ(Stream::range(1, 100).With(Policy).Reduce(std::vector<int>{}, Append, Join).Collect()[0], Stream::range(1, 100).Collect());
+}
+
+TEST(Stream, ParMap)
+{
+    auto Pool = Stream::ThreadPool{4, 8};
+    const auto Expected = Stream::range(1, 100).Map([](int Value){ return Value * Value; }).Collect();
+
+    EXPECT_EQ(Stream::range(1, 100).ParMap([](int Value){ return Value * Value; }, Pool).Collect(), Expected);
+    EXPECT_EQ(Stream::range(1, 100).Filter([](int Value){ return Value % 2; }).ParMap([](int Value){ return Value; }, Pool).Count(), 50);
+}
+
+TEST(Stream, ParFilterReject)
+{
+    auto Pool = Stream::ThreadPool{4, 8};
+    const auto Evens = Stream::range(1, 100).ParFilter([](int Value){ return Value % 2 == 0; }, Pool).Collect();
+    const auto Odds = Stream::range(1, 100).ParReject([](int Value){ return Value % 2 == 0; }, Pool).Collect();
+
+    EXPECT_EQ(Evens, Stream::range(1, 50).Map([](int Value){ return Value * 2; }).Collect());
+    EXPECT_EQ(Odds.front(), 1);
+    EXPECT_EQ(Odds.back(), 99);
+    EXPECT_EQ(Stream::range(1, 100).With({.Grain = 8}).Par(Pool).Sum(), 5050);
+}
+
+TEST(Stream, ParEachPropagatesExceptions)
+{
+    auto Pool = Stream::ThreadPool{2, 4};
+    auto Throwing = [](int Value){ if (Value == 50) throw std::runtime_error("Fail"); };
+
+    EXPECT_THROW(Stream::range(1, 100).ParEach(Throwing, Pool), std::runtime_error);
+}
+
+TEST(Stream, MappedFile)
+{
+    const auto Path = std::filesystem::temp_directory_path() / "stream_mmap_test.txt";
+    std::ofstream(Path, std::ios::binary) << "first\nsecond\r\n\nlast";
+
+    EXPECT_EQ(Stream::mmap(Path).Count(), 19);
+    EXPECT_EQ(Stream::mmap(Path).View.Span().front(), 'f');
+
+    const auto Expected = std::vector<std::string_view>{"first", "second", "", "last"};
+    EXPECT_EQ(Stream::lines(Path).Collect(), Expected);
+
+    auto Input = std::ifstream(Path, std::ios::binary);
+    const auto Copied = Stream::lines(Input)
+        .Map([](std::string_view Line){ return std::string(Line); })
+        .Collect();
+    EXPECT_EQ(Copied, (std::vector<std::string>{"first", "second", "", "last"}));
+
+    const auto Sizes = Stream::bytes(Path, 8)
+        .Map([](std::span<const char> Block){ return Block.size(); })
+        .Collect();
+    EXPECT_EQ(Sizes, (std::vector<std::size_t>{8, 8, 3}));
+
+    std::filesystem::remove(Path);
+}
+
+TEST(Stream, BlockFile)
+{
+    struct Trade
+    {
+        std::int64_t Id;
+        double Price;
+    };
+
+    const auto Path = std::filesystem::temp_directory_path() / "stream_block_test.bin";
+
+    // Small blocks so the file holds many of them, the last one partial
+    const auto Written = Stream::range(1, 10000).Map([](int Id){ return Trade{Id, Id * 0.5}; }).WriteTo(Path, Stream::Compression::None, 4096);
+    EXPECT_EQ(Written, 10000);
+
+    auto Trades = Stream::read<Trade>(Path);
+    EXPECT_EQ(Trades.Count(), 10000);
+    EXPECT_EQ(Trades.Map([](const Trade& Value){ return Value.Id; }).Sum(), 50005000);
+    EXPECT_DOUBLE_EQ(Stream::read<Trade>(Path).Map(&Trade::Price).Stats()->Max, 5000.0);
+    EXPECT_THROW(Stream::read<int>(Path), std::runtime_error);
+
+    // A flipped payload byte fails its block's checksum when iteration reaches it
+    {
+        auto File = std::fstream(Path, std::ios::binary | std::ios::in | std::ios::out);
+        File.seekp(100);
+        File.put('\x7F');
+    }
+    EXPECT_THROW(Stream::read<Trade>(Path).Count(), std::runtime_error);
+
+    Stream::of(std::vector<std::uint16_t>{}).WriteTo(Path);
+    EXPECT_EQ(Stream::read<std::uint16_t>(Path).Count(), 0);
+
+#if !STREAM_LZ4
+    EXPECT_THROW(Stream::range(1, 3).WriteTo(Path, Stream::Compression::LZ4), std::invalid_argument);
+#endif
+
+    // Block headers count bytes in 32 bits, so a block of 4 GiB or more is refused before anything is buffered
+    EXPECT_THROW(Stream::range(1, 3).WriteTo(Path, Stream::Compression::None, std::size_t{1} << 32), std::invalid_argument);
+
+    std::filesystem::remove(Path);
+}
+
+TEST(Stream, AsyncStream)
+{
+    auto Source = []() -> Stream::AsyncGenerator<int>
+    {
+        for (auto Value = 1; Value <= 10; ++Value)
+            co_yield Value;
+    };
+    auto Square = [](int Value) -> Stream::Task<int> { co_return Value * Value; };
+
+    const auto Result = Stream::SyncWait(Stream::async(Source())
+        .Filter([](int Value){ return Value % 2 == 0; })
+        .Map(Square)
+        .Take(3)
+        .Collect());
+    EXPECT_EQ(Result, (std::vector{4, 16, 36}));
+
+    auto Seen = 0;
+    EXPECT_EQ(Stream::SyncWait(Stream::async(Stream::range(1, 4)).Each([&Seen](int){ ++Seen; }).Reduce(0, std::plus{})), 10);
+    EXPECT_EQ(Seen, 4);
+    EXPECT_EQ(Stream::SyncWait(Stream::async(Stream::range(1, 4)).ForEach(Stream::counter())).Count, 4u);
+
+    auto Failing = Stream::async(Stream::range(1, 4)).Map([](int Value){ return Value < 3 ? Value : throw std::runtime_error("boom"); }).Run();
+    EXPECT_THROW(Stream::SyncWait(std::move(Failing)), std::runtime_error);
+}
+
+TEST(Stream, AsyncChannel)
+{
+    constexpr auto Capacity = 4;
+    auto Queue = Stream::Channel<int>(Capacity);
+    auto Sent = std::atomic<int>{0};
+    auto Received = std::atomic<int>{0};
+    auto MaxAhead = std::atomic<int>{0};
+
+    auto Producer = std::jthread([&]
+    {
+        Stream::SyncWait(Stream::async(Stream::range(1, 1000))
+            .Each([&](int){ Sent.fetch_add(1); })
+            .Into(Queue));
+    });
+
+    const auto Sum = Stream::SyncWait(Stream::async(Queue)
+        .Each([&](int)
+        {
+            MaxAhead.store(std::max(MaxAhead.load(), Sent.load() - Received.load()));
+            Received.fetch_add(1);
+        })
+        .Reduce(0, std::plus{}));
+
+    EXPECT_EQ(Sum, 500500);
+    EXPECT_LE(MaxAhead.load(), Capacity + 2);
+}
+
+TEST(Stream, Ring)
+{
+    auto Queue = Stream::Ring<int>(4);
+    auto Values = std::vector{1, 2, 3, 4, 5, 6};
+    auto Popped = std::vector<int>(6);
+
+    EXPECT_EQ(Queue.Capacity(), 4u);
+    EXPECT_EQ(Queue.TryPush(Values), 4u);
+    EXPECT_EQ(Queue.TryPush(std::span(Values).subspan(4)), 0u);
+    EXPECT_EQ(Queue.TryPop(std::span(Popped).first(3)), 3u);
+    EXPECT_EQ(Queue.TryPush(std::span(Values).subspan(4)), 2u);
+    EXPECT_EQ(Queue.TryPop(std::span(Popped).subspan(3)), 3u);
+    EXPECT_EQ(Popped, (std::vector{1, 2, 3, 4, 5, 6}));
+
+    Queue.Close();
+    EXPECT_TRUE(Queue.IsClosed());
+    EXPECT_EQ(Queue.Pop(Popped), 0u);
+}
+
+TEST(Stream, RingPipeline)
+{
+    constexpr auto Producers = 3;
+    auto Queue = Stream::Ring<std::int64_t>(64, Producers);
+
+    auto Threads = std::vector<std::jthread>{};
+    for (auto Producer = 0; Producer < Producers; ++Producer)
+    {
+        Threads.emplace_back([&Queue]
+        {
+            Stream::range(1, 20000).Map([](int Value){ return std::int64_t{Value}; }).Into(Queue, 32);
+        });
+    }
+
+    auto Partial = std::atomic<std::int64_t>{0};
+    auto Consumer = std::jthread([&]{ Partial += Stream::from(Queue, 16).Sum(); });
+    const auto Total = Stream::from(Queue).Filter([](std::int64_t Value){ return Value > 0; }).Sum();
+
+    Threads.clear();
+    Consumer.join();
+    EXPECT_EQ(Total + Partial.load(), std::int64_t{Producers} * 20000 * 20001 / 2);
+}
+
+TEST(Stream, Profile)
+{
+    auto Reports = std::vector<Stream::StageReport>{};
+    {
+        auto Profiler = Stream::Profiler("orders", [&Reports](std::string_view Name, std::span<const Stream::StageReport> Stages)
+        {
+            EXPECT_EQ(Name, "orders");
+            Reports.assign(Stages.begin(), Stages.end());
+        }, 1);
+
+        const auto Result = Stream::range(1, 100)
+            .Profile(Profiler)
+            .Filter([](int Value){ return Value % 4 == 0; })
+            .Map([](int Value){ return Value / 4; })
+            .Take(10)
+            .Collect();
+        EXPECT_EQ(Result, Stream::range(1, 10).Collect());
+    }
+
+    if constexpr (STREAM_PROFILE)
+    {
+        ASSERT_EQ(Reports.size(), 3u);
+        EXPECT_EQ(Reports[0].Kind, "Filter");
+        // Take advances past its last element, so the filter runs on to the 11th match
+        EXPECT_EQ(Reports[0].In, 44u);
+        EXPECT_EQ(Reports[0].Out, 11u);
+        EXPECT_DOUBLE_EQ(Reports[0].Selectivity(), 0.25);
+        EXPECT_EQ(Reports[0].Samples, 44u);
+        EXPECT_EQ(Reports[1].Kind, "Map");
+        EXPECT_EQ(Reports[2].Kind, "Take");
+        EXPECT_EQ(Reports[2].In, Reports[1].Out);
+    }
+    else
+    {
+        EXPECT_TRUE(Reports.empty());
+    }
+}
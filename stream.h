@@ -4,219 +4,6593 @@
 #undef max
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
 #include <numeric>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
-template<typename T>
-struct StreamImpl
+// Define to 1 to make the stages added after Profile() record counts and timings
+#if !defined(STREAM_PROFILE)
+#define STREAM_PROFILE 0
+#endif
+
+// Define to 0 to leave out the file-backed sources and WriteTo, along with the platform headers they need
+#if !defined(STREAM_FILES)
+#define STREAM_FILES 1
+#endif
+
+#if STREAM_FILES && defined(_WIN32)
+// Keep <windows.h> from defining min/max macros and pulling in the rest of the Win32 API for our includers
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define STREAM_UNDEF_NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define STREAM_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#if defined(STREAM_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef STREAM_UNDEF_NOMINMAX
+#endif
+#if defined(STREAM_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef STREAM_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#elif STREAM_FILES
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Define to 1 (and link liblz4) to let WriteTo compress blocks and Stream::read decompress them
+#if !defined(STREAM_LZ4)
+#define STREAM_LZ4 0
+#endif
+
+#if STREAM_LZ4
+#include <lz4.h>
+#endif
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define STREAM_HAS_SIMD 1
+#endif
+
+namespace Stream
 {
-    T View{};
+    /// Reusable pool of workers with one task deque each; owners pop from the back, idle workers steal from the front.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t Workers = 0, std::size_t Grain = 1024)
+            : Queues(Workers ? Workers : std::max(1u, std::thread::hardware_concurrency())), DefaultGrain(std::max<std::size_t>(Grain, 1))
+        {
+            Threads.reserve(Queues.size());
+            for (auto Worker = std::size_t{0}; Worker < Queues.size(); ++Worker)
+                Threads.emplace_back([this, Worker]{ WorkerLoop(Worker); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                auto Lock = std::scoped_lock{WorkMutex};
+                Stopping = true;
+            }
+
+            WorkCondition.notify_all();
+            Threads.clear();
+        }
+
+        /// Returns the number of worker threads.
+        std::size_t Size() const { return Queues.size(); }
+
+        /// Returns the number of elements per task used when a call doesn't pick its own grain.
+        std::size_t Grain() const { return DefaultGrain; }
+
+        /// Runs Func(Begin, End) over grain-sized chunks of [0, Count) and waits for all of them.
+        /// The calling thread helps with queued tasks while it waits; the first exception thrown by a chunk is rethrown.
+        template<typename F>
+        void ParallelFor(std::size_t Count, F&& Func, std::size_t Grain = 0)
+        {
+            if (Count == 0)
+                return;
+
+            Grain = Grain ? Grain : DefaultGrain;
+
+            auto Chunks = (Count + Grain - 1) / Grain;
+            auto Owner = Job{.Remaining = Chunks};
+            auto Run = [](void* Context, std::size_t Begin, std::size_t End)
+            {
+                (*static_cast<std::remove_reference_t<F>*>(Context))(Begin, End);
+            };
+
+            // Count the tasks before queueing them so a thief never sees Pending drop below zero
+            {
+                auto Lock = std::scoped_lock{WorkMutex};
+                Pending += Chunks;
+            }
+
+            for (auto Begin = std::size_t{0}; Begin < Count; Begin += Grain)
+            {
+                auto Queue = CurrentPool == this ? CurrentWorker : NextQueue++ % Queues.size();
+                auto Lock = std::scoped_lock{Queues[Queue].Mutex};
+                Queues[Queue].Tasks.push_back({Run, std::addressof(Func), &Owner, Begin, std::min(Begin + Grain, Count)});
+            }
+
+            WorkCondition.notify_all();
+
+            while (true)
+            {
+                {
+                    auto Lock = std::scoped_lock{DoneMutex};
+                    if (Owner.Remaining == 0)
+                        break;
+                }
+
+                if (RunOne())
+                    continue;
+
+                auto Lock = std::unique_lock{DoneMutex};
+                DoneCondition.wait_for(Lock, std::chrono::milliseconds(1), [&Owner]{ return Owner.Remaining == 0; });
+            }
+
+            if (Owner.Error)
+                std::rethrow_exception(Owner.Error);
+        }
+
+    private:
+        struct Job
+        {
+            std::size_t Remaining = 0;
+            std::exception_ptr Error{};
+        };
+
+        struct Task
+        {
+            void (*Run)(void*, std::size_t, std::size_t) = nullptr;
+            void* Context = nullptr;
+            Job* Owner = nullptr;
+            std::size_t Begin = 0;
+            std::size_t End = 0;
+        };
+
+        struct Queue
+        {
+            std::mutex Mutex{};
+            std::deque<Task> Tasks{};
+        };
+
+        /// Takes a task from the current worker's own deque, or steals one from another deque, and runs it.
+        bool RunOne()
+        {
+            auto Found = std::optional<Task>{};
+            auto Own = CurrentPool == this;
+
+            if (Own)
+            {
+                auto Lock = std::scoped_lock{Queues[CurrentWorker].Mutex};
+                if (!Queues[CurrentWorker].Tasks.empty())
+                {
+                    Found = Queues[CurrentWorker].Tasks.back();
+                    Queues[CurrentWorker].Tasks.pop_back();
+                }
+            }
+
+            auto Start = Own ? CurrentWorker + 1 : NextQueue.load(std::memory_order_relaxed);
+            for (auto Offset = std::size_t{0}; !Found && Offset < Queues.size(); ++Offset)
+            {
+                auto& Victim = Queues[(Start + Offset) % Queues.size()];
+                auto Lock = std::scoped_lock{Victim.Mutex};
+                if (!Victim.Tasks.empty())
+                {
+                    Found = Victim.Tasks.front();
+                    Victim.Tasks.pop_front();
+                }
+            }
+
+            if (!Found)
+                return false;
+
+            Pending.fetch_sub(1, std::memory_order_relaxed);
+
+            auto Error = std::exception_ptr{};
+            try
+            {
+                Found->Run(Found->Context, Found->Begin, Found->End);
+            }
+            catch (...)
+            {
+                Error = std::current_exception();
+            }
+
+            auto Lock = std::scoped_lock{DoneMutex};
+            if (Error && !Found->Owner->Error)
+                Found->Owner->Error = Error;
+
+            if (--Found->Owner->Remaining == 0)
+                DoneCondition.notify_all();
+
+            return true;
+        }
+
+        void WorkerLoop(std::size_t Worker)
+        {
+            CurrentPool = this;
+            CurrentWorker = Worker;
+
+            while (true)
+            {
+                if (RunOne())
+                    continue;
+
+                auto Lock = std::unique_lock{WorkMutex};
+                WorkCondition.wait(Lock, [this]{ return Stopping || Pending.load(std::memory_order_relaxed) > 0; });
+
+                if (Stopping)
+                    return;
+            }
+        }
+
+        inline static thread_local ThreadPool* CurrentPool = nullptr;
+        inline static thread_local std::size_t CurrentWorker = 0;
+
+        std::vector<Queue> Queues;
+        std::size_t DefaultGrain = 1024;
+        std::atomic<std::size_t> NextQueue = 0;
+        std::atomic<std::size_t> Pending = 0;
+
+        std::mutex WorkMutex{};
+        std::condition_variable WorkCondition{};
+        bool Stopping = false;
+
+        std::mutex DoneMutex{};
+        std::condition_variable DoneCondition{};
+
+        std::vector<std::jthread> Threads{};
+    };
+
+    /// Counters of one stage attached to a Profiler.
+    struct StageProfile
+    {
+        std::string Kind;
+        bool InFromPrevious = false;
+        std::uint64_t SampleEvery = 64;
+        std::atomic<std::uint64_t> In{0};
+        std::atomic<std::uint64_t> Out{0};
+        std::atomic<std::uint64_t> Samples{0};
+        std::atomic<std::uint64_t> Nanoseconds{0};
+        std::atomic<std::uint64_t> Allocations{0};
+    };
+
+    /// Snapshot of one profiled stage, as handed to a Profiler's reporter; it owns its strings, so it outlives the profiler.
+    struct StageReport
+    {
+        std::string Kind;
+        std::uint64_t In = 0;
+        std::uint64_t Out = 0;
+        std::uint64_t Samples = 0;
+        std::uint64_t Nanoseconds = 0;
+        std::uint64_t Allocations = 0;
+
+        /// Share of the stage's input it passed on.
+        double Selectivity() const { return In ? static_cast<double>(Out) / static_cast<double>(In) : 0.0; }
+
+        /// Time spent in the stage's function, extrapolated from the sampled calls.
+        double EstimatedNanoseconds() const { return Samples ? static_cast<double>(Nanoseconds) * static_cast<double>(In) / static_cast<double>(Samples) : 0.0; }
+    };
+
+    /// Collects per-stage element counts, sampled timings and allocations for the stages a stream adds after
+    /// Profile(), and hands them to a reporter on Report() or destruction. Stages only record anything when
+    /// STREAM_PROFILE is defined to 1; otherwise they compile exactly as without a profiler.
+    class Profiler
+    {
+    public:
+        using Reporter = std::function<void(std::string_view Name, std::span<const StageReport> Stages)>;
+
+        /// Creates a profiler timing one call in 'SampleEvery' of each stage function.
+        explicit Profiler(std::string Name, Reporter Callback = Print, std::uint64_t SampleEvery = 64)
+            : Name(std::move(Name)), Callback(std::move(Callback)), SampleEvery(std::max<std::uint64_t>(SampleEvery, 1)) {}
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        ~Profiler()
+        {
+            if (!Reported)
+                Report();
+        }
+
+        /// Registers a stage; stages that can't observe their input report the previous stage's output as it.
+        StageProfile& AddStage(std::string Kind, bool InFromPrevious = false)
+        {
+            auto Lock = std::scoped_lock{Mutex};
+            auto& Stage = Stages.emplace_back();
+            Stage.Kind = std::move(Kind);
+            Stage.InFromPrevious = InFromPrevious;
+            Stage.SampleEvery = SampleEvery;
+            return Stage;
+        }
+
+        /// Hands a snapshot of every stage to the reporter.
+        void Report()
+        {
+            auto Lock = std::scoped_lock{Mutex};
+            auto Reports = std::vector<StageReport>{};
+            Reports.reserve(Stages.size());
+
+            for (auto& Stage : Stages)
+            {
+                auto Out = Stage.Out.load(std::memory_order_relaxed);
+                auto In = Stage.InFromPrevious ? (Reports.empty() ? 0 : Reports.back().Out) : Stage.In.load(std::memory_order_relaxed);
+                Reports.push_back({Stage.Kind, In, Out, Stage.Samples.load(std::memory_order_relaxed),
+                    Stage.Nanoseconds.load(std::memory_order_relaxed), Stage.Allocations.load(std::memory_order_relaxed)});
+            }
+
+            Reported = true;
+            if (Callback)
+                Callback(Name, Reports);
+        }
+
+        /// Counts an allocation made by the calling thread; call it from a replacement operator new, or define
+        /// STREAM_PROFILE_ALLOCATIONS in exactly one translation unit to get one.
+        static void CountAllocation() noexcept { ++ThreadAllocations(); }
+
+        /// Allocations counted on the calling thread so far.
+        static std::uint64_t& ThreadAllocations() noexcept
+        {
+            thread_local std::uint64_t Count = 0;
+            return Count;
+        }
+
+        /// Default reporter: prints one line per stage to stderr.
+        static void Print(std::string_view Name, std::span<const StageReport> Stages)
+        {
+            std::fprintf(stderr, "%.*s\n", static_cast<int>(Name.size()), Name.data());
+            for (auto Index = std::size_t{0}; Index < Stages.size(); ++Index)
+            {
+                const auto& Stage = Stages[Index];
+                std::fprintf(stderr, "  #%zu %-8.*s in %10llu  out %10llu  selectivity %6.2f%%  ~%.3f ms  %llu allocations in %llu samples\n",
+                    Index, static_cast<int>(Stage.Kind.size()), Stage.Kind.data(), static_cast<unsigned long long>(Stage.In),
+                    static_cast<unsigned long long>(Stage.Out), Stage.Selectivity() * 100.0, Stage.EstimatedNanoseconds() / 1e6,
+                    static_cast<unsigned long long>(Stage.Allocations), static_cast<unsigned long long>(Stage.Samples));
+            }
+        }
+
+    private:
+        std::string Name;
+        Reporter Callback;
+        std::uint64_t SampleEvery;
+        std::mutex Mutex{};
+        std::deque<StageProfile> Stages{};
+        bool Reported = false;
+    };
+
+    /// Describes how terminals execute a pipeline.
+    struct ExecutionPolicy
+    {
+        /// Number of threads to fan out to: 1 runs on the calling thread, 0 uses every hardware thread (or every pool worker).
+        std::size_t Workers = 1;
+
+        /// Minimum number of elements handed to each worker.
+        std::size_t Grain = 16384;
+
+        /// Pool to run slices on; when null, terminals start their own threads.
+        ThreadPool* Pool = nullptr;
+
+        /// Profiler the following stages record into when STREAM_PROFILE is enabled; see StreamImpl::Profile.
+        Stream::Profiler* Profiler = nullptr;
+    };
+
+    inline constexpr ExecutionPolicy Sequential{};
+    inline constexpr ExecutionPolicy Parallel{.Workers = 0};
+
+    namespace Detail
+    {
+        /// Accumulator Sum uses by default: 64-bit for integers so narrow types can't overflow, the element type otherwise.
+        template<typename V>
+        using SumType = std::conditional_t<std::is_integral_v<V>, std::conditional_t<std::is_signed_v<V>, std::int64_t, std::uint64_t>, V>;
+    }
+
+    /// Summary of an arithmetic stream computed in a single pass by StreamImpl::Stats().
+    template<typename V>
+    struct Statistics
+    {
+        std::size_t Count = 0;
+        Detail::SumType<V> Sum{};
+        V Min{};
+        V Max{};
+        double Mean = 0.0;
+
+        /// Population variance.
+        double Variance = 0.0;
+
+        /// Adds a value, updating the mean and variance with Welford's method.
+        constexpr void Add(const V& Value)
+        {
+            Min = Count == 0 || Value < Min ? Value : Min;
+            Max = Count == 0 || Max < Value ? Value : Max;
+            Sum += Value;
+
+            auto Delta = static_cast<double>(Value) - Mean;
+            Mean += Delta / static_cast<double>(++Count);
+            SquaredDeltas += Delta * (static_cast<double>(Value) - Mean);
+            Variance = SquaredDeltas / static_cast<double>(Count);
+        }
+
+        /// Combines the statistics of another part of the stream (Chan's parallel update).
+        constexpr void Merge(const Statistics& Other)
+        {
+            if (Other.Count == 0)
+                return;
+
+            if (Count == 0)
+            {
+                *this = Other;
+                return;
+            }
+
+            auto Total = static_cast<double>(Count + Other.Count);
+            auto Delta = Other.Mean - Mean;
+
+            Min = Other.Min < Min ? Other.Min : Min;
+            Max = Max < Other.Max ? Other.Max : Max;
+            Sum += Other.Sum;
+            Mean += Delta * static_cast<double>(Other.Count) / Total;
+            SquaredDeltas += Other.SquaredDeltas + Delta * Delta * static_cast<double>(Count) * static_cast<double>(Other.Count) / Total;
+            Count += Other.Count;
+            Variance = SquaredDeltas / Total;
+        }
+
+    private:
+        double SquaredDeltas = 0.0;
+    };
+
+    /// Monotonic memory resource that serves allocations from an inline buffer first and frees everything at once.
+    /// Pass its address to CollectInto for std::pmr containers, e.g. CollectInto<std::pmr::vector<int>>(&Arena).
+    template<std::size_t InlineBytes = 4096>
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        Arena() = default;
+        explicit Arena(std::pmr::memory_resource* Upstream) : Resource(Buffer.data(), Buffer.size(), Upstream) {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /// Frees every allocation made from the arena.
+        void Release() { Resource.release(); }
+
+    private:
+        void* do_allocate(std::size_t Bytes, std::size_t Alignment) override { return Resource.allocate(Bytes, Alignment); }
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override { return this == &Other; }
+
+        alignas(std::max_align_t) std::array<std::byte, InlineBytes> Buffer;
+        std::pmr::monotonic_buffer_resource Resource{Buffer.data(), Buffer.size()};
+    };
+
+    /// Selects how Sum accumulates floating point values.
+    enum class Summation
+    {
+        /// Independent accumulators per lane, vectorized for contiguous arithmetic views.
+        Fast,
+        /// Fixed-size blocks combined pairwise, keeping the error growth logarithmic.
+        Pairwise,
+        /// Compensated (Kahan-Neumaier) summation.
+        Kahan,
+    };
+
+    /// Selects how WriteTo compresses the blocks it writes.
+    enum class Compression
+    {
+        /// Elements stored as they are, so Stream::read serves them straight from the mapping.
+        None,
+        /// LZ4 per block (needs STREAM_LZ4 defined to 1 and liblz4); blocks it can't shrink stay uncompressed.
+        LZ4,
+    };
+
+    /// Bounded lock-free multi-producer multi-consumer channel over a ring of sequenced cells (Vyukov's queue).
+    /// Batches claim a run of cells with a single CAS. Each of the 'Producers' producers calls Close() once when
+    /// it is done; consumers drain what is left and then see the end of the stream.
+    template<typename T>
+        requires std::default_initializable<T> && std::movable<T>
+    class Ring
+    {
+    public:
+        /// Creates a ring holding at least 'Capacity' elements (rounded up to a power of two).
+        explicit Ring(std::size_t Capacity, std::size_t Producers = 1)
+            : Mask(std::bit_ceil(std::max<std::size_t>(Capacity, 2)) - 1), Cells(std::make_unique<Cell[]>(Mask + 1)), OpenProducers(Producers)
+        {
+            for (auto Index = std::size_t{0}; Index <= Mask; ++Index)
+                Cells[Index].Sequence.store(Index, std::memory_order_relaxed);
+        }
+
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+
+        /// Moves as many leading values as there are free cells into the ring and returns how many it took.
+        std::size_t TryPush(std::span<T> Values)
+        {
+            auto Position = EnqueuePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                // A cell is free for 'Position' once its sequence has come round to it
+                auto Count = std::size_t{0};
+                while (Count < Values.size() && Cells[(Position + Count) & Mask].Sequence.load(std::memory_order_acquire) == Position + Count)
+                    ++Count;
+
+                if (Count == 0)
+                {
+                    auto Current = EnqueuePosition.load(std::memory_order_relaxed);
+                    if (Current == Position)
+                        return 0;
+
+                    Position = Current;
+                    continue;
+                }
+
+                if (EnqueuePosition.compare_exchange_weak(Position, Position + Count, std::memory_order_relaxed))
+                {
+                    for (auto Index = std::size_t{0}; Index < Count; ++Index)
+                    {
+                        auto& Slot = Cells[(Position + Index) & Mask];
+                        Slot.Value = std::move(Values[Index]);
+                        Slot.Sequence.store(Position + Index + 1, std::memory_order_release);
+                    }
+                    return Count;
+                }
+            }
+        }
+
+        /// Moves up to Values.size() elements out of the ring and returns how many it wrote.
+        std::size_t TryPop(std::span<T> Values)
+        {
+            auto Position = DequeuePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto Count = std::size_t{0};
+                while (Count < Values.size() && Cells[(Position + Count) & Mask].Sequence.load(std::memory_order_acquire) == Position + Count + 1)
+                    ++Count;
+
+                if (Count == 0)
+                {
+                    auto Current = DequeuePosition.load(std::memory_order_relaxed);
+                    if (Current == Position)
+                        return 0;
+
+                    Position = Current;
+                    continue;
+                }
+
+                if (DequeuePosition.compare_exchange_weak(Position, Position + Count, std::memory_order_relaxed))
+                {
+                    for (auto Index = std::size_t{0}; Index < Count; ++Index)
+                    {
+                        auto& Slot = Cells[(Position + Index) & Mask];
+                        Values[Index] = std::move(Slot.Value);
+                        Slot.Sequence.store(Position + Index + Mask + 1, std::memory_order_release);
+                    }
+                    return Count;
+                }
+            }
+        }
+
+        /// Moves all the values into the ring, yielding while it is full.
+        void Push(std::span<T> Values)
+        {
+            while (!Values.empty())
+            {
+                auto Count = TryPush(Values);
+                if (Count == 0)
+                    std::this_thread::yield();
+
+                Values = Values.subspan(Count);
+            }
+        }
+
+        /// Moves at least one element out of the ring, yielding while it is empty; returns 0 once it is closed and drained.
+        std::size_t Pop(std::span<T> Values)
+        {
+            while (true)
+            {
+                if (auto Count = TryPop(Values))
+                    return Count;
+
+                // Every push happens before its producer's Close(), so one more attempt sees them all
+                if (IsClosed())
+                    return TryPop(Values);
+
+                std::this_thread::yield();
+            }
+        }
+
+        /// Marks one producer as finished; the ring closes once all of them have.
+        void Close()
+        {
+            if (OpenProducers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Closed.store(true, std::memory_order_release);
+        }
+
+        bool IsClosed() const { return Closed.load(std::memory_order_acquire); }
+        std::size_t Capacity() const { return Mask + 1; }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence{};
+            T Value{};
+        };
+
+        std::size_t Mask;
+        std::unique_ptr<Cell[]> Cells;
+        alignas(64) std::atomic<std::size_t> EnqueuePosition{0};
+        alignas(64) std::atomic<std::size_t> DequeuePosition{0};
+        alignas(64) std::atomic<std::size_t> OpenProducers;
+        std::atomic<bool> Closed{false};
+    };
+}
+
+namespace Stream::Detail
+{
+    /// Tuple of references yielded by zipped and columnar views. Unlike a C++20 std::tuple of references, it has a
+    /// common reference with the std::tuple of values that is those views' value type (as C++23 tuples do), so
+    /// terminals that store elements copy them out instead of keeping references into the sources.
+    template<typename... R>
+    struct TupleRef : std::tuple<R...>
+    {
+        using std::tuple<R...>::tuple;
+
+        /// Refers to the elements of a tuple of values (the C++23 std::tuple constructor from a non-const lvalue).
+        template<typename... U> requires (sizeof...(U) == sizeof...(R)) && (std::convertible_to<U&, R> && ...)
+        constexpr TupleRef(std::tuple<U...>& Values)
+            : std::tuple<R...>(std::apply([](auto&... Value){ return std::tuple<R...>(Value...); }, Values)) {}
+
+        template<typename... U> requires (sizeof...(U) == sizeof...(R)) && (std::convertible_to<const U&, R> && ...)
+        constexpr TupleRef(const std::tuple<U...>& Values)
+            : std::tuple<R...>(std::apply([](const auto&... Value){ return std::tuple<R...>(Value...); }, Values)) {}
+    };
+}
+
+template<typename... R>
+struct std::tuple_size<Stream::Detail::TupleRef<R...>> : std::integral_constant<std::size_t, sizeof...(R)> {};
+
+template<std::size_t I, typename... R>
+struct std::tuple_element<I, Stream::Detail::TupleRef<R...>> : std::tuple_element<I, std::tuple<R...>> {};
+
+template<typename... R, typename... U, template<typename> typename RQual, template<typename> typename UQual>
+    requires (sizeof...(R) == sizeof...(U)) && requires { typename std::tuple<std::common_reference_t<RQual<R>, UQual<U>>...>; }
+struct std::basic_common_reference<Stream::Detail::TupleRef<R...>, std::tuple<U...>, RQual, UQual>
+{
+    using type = Stream::Detail::TupleRef<std::common_reference_t<RQual<R>, UQual<U>>...>;
+};
+
+template<typename... U, typename... R, template<typename> typename UQual, template<typename> typename RQual>
+    requires (sizeof...(R) == sizeof...(U)) && requires { typename std::tuple<std::common_reference_t<UQual<U>, RQual<R>>...>; }
+struct std::basic_common_reference<std::tuple<U...>, Stream::Detail::TupleRef<R...>, UQual, RQual>
+{
+    using type = Stream::Detail::TupleRef<std::common_reference_t<UQual<U>, RQual<R>>...>;
+};
+
+namespace Stream::Detail
+{
+    /// Returns how many slices a parallel terminal should split 'Count' elements into.
+    inline std::size_t SliceCount(std::size_t Count, const ExecutionPolicy& Policy)
+    {
+        auto Workers = Policy.Workers ? Policy.Workers : Policy.Pool ? Policy.Pool->Size() : std::max(1u, std::thread::hardware_concurrency());
+        auto Grain = std::max<std::size_t>(Policy.Grain, 1);
+        return std::clamp<std::size_t>((Count + Grain - 1) / Grain, 1, Workers);
+    }
+
+    /// Runs Func(Slot, Begin, End) over 'Slices' contiguous slices of [0, Count), one thread (or pool task) per slice.
+    /// The calling thread runs the first slice; the first exception thrown by any slice is rethrown.
+    template<typename F>
+    void ParallelFor(std::size_t Count, std::size_t Slices, const ExecutionPolicy& Policy, F&& Func)
+    {
+        if (Policy.Pool)
+        {
+            Policy.Pool->ParallelFor(Slices, [&](std::size_t First, std::size_t Last)
+            {
+                for (auto Slot = First; Slot < Last; ++Slot)
+                    Func(Slot, Count * Slot / Slices, Count * (Slot + 1) / Slices);
+            }, 1);
+            return;
+        }
+
+        auto Errors = std::vector<std::exception_ptr>(Slices);
+        auto RunSlice = [&](std::size_t Slot)
+        {
+            try
+            {
+                Func(Slot, Count * Slot / Slices, Count * (Slot + 1) / Slices);
+            }
+            catch (...)
+            {
+                Errors[Slot] = std::current_exception();
+            }
+        };
+
+        {
+            auto Threads = std::vector<std::jthread>{};
+            Threads.reserve(Slices - 1);
+
+            for (auto Slot = std::size_t{1}; Slot < Slices; ++Slot)
+                Threads.emplace_back(RunSlice, Slot);
+
+            RunSlice(0);
+        }
+
+        for (auto& Error : Errors)
+        {
+            if (Error)
+                std::rethrow_exception(Error);
+        }
+    }
+
+    /// Folds [Begin, End) from the left like std::accumulate, but also accepts a sentinel that differs from the iterator type.
+    template<typename I, typename S, typename Acc, typename F>
+    constexpr Acc Accumulate(I Begin, S End, Acc Result, F& Func)
+    {
+        for (; Begin != End; ++Begin)
+            Result = Func(std::move(Result), *Begin);
+
+        return Result;
+    }
+
+    /// Sums contiguous arithmetic values into several independent accumulators so the loop vectorizes.
+    template<typename Acc, typename V>
+    constexpr Acc SumContiguous(const V* Data, std::size_t Size)
+    {
+        auto Index = std::size_t{0};
+        auto Result = Acc{};
+
+#if defined(STREAM_HAS_SIMD)
+        if constexpr (std::is_same_v<Acc, V> && std::is_arithmetic_v<V> && !std::is_same_v<V, bool>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                namespace Simd = std::experimental;
+                using Vector = Simd::native_simd<V>;
+
+                constexpr auto Width = Vector::size();
+                auto Partials = std::array<Vector, 4>{};
+
+                for (; Index + Width * Partials.size() <= Size; Index += Width * Partials.size())
+                {
+                    for (auto Lane = std::size_t{0}; Lane < Partials.size(); ++Lane)
+                        Partials[Lane] += Vector(Data + Index + Lane * Width, Simd::element_aligned);
+                }
+
+                Result = Simd::reduce((Partials[0] + Partials[1]) + (Partials[2] + Partials[3]));
+            }
+        }
+#endif
+
+        constexpr auto Lanes = std::size_t{8};
+        auto Partials = std::array<Acc, Lanes>{};
+
+        for (; Index + Lanes <= Size; Index += Lanes)
+        {
+            for (auto Lane = std::size_t{0}; Lane < Lanes; ++Lane)
+                Partials[Lane] += static_cast<Acc>(Data[Index + Lane]);
+        }
+
+        for (; Index < Size; ++Index)
+            Partials[0] += static_cast<Acc>(Data[Index]);
+
+        return Result + (((Partials[0] + Partials[1]) + (Partials[2] + Partials[3])) + ((Partials[4] + Partials[5]) + (Partials[6] + Partials[7])));
+    }
+
+    /// Sums blocks of 128 values and combines the block sums like a binary counter, so the sum is pairwise in one pass.
+    template<typename Acc, typename I, typename S>
+    constexpr Acc SumPairwise(I Begin, S End)
+    {
+        constexpr auto BlockSize = 128;
+
+        auto Levels = std::array<Acc, 64>{};
+        auto Filled = std::uint64_t{0};
+        auto Block = Acc{};
+        auto InBlock = 0;
+
+        for (; Begin != End; ++Begin)
+        {
+            Block += static_cast<Acc>(*Begin);
+            if (++InBlock < BlockSize)
+                continue;
+
+            auto Level = 0;
+            for (; Filled & (std::uint64_t{1} << Level); ++Level)
+            {
+                Block = Levels[Level] + Block;
+                Filled &= ~(std::uint64_t{1} << Level);
+            }
+
+            Levels[Level] = Block;
+            Filled |= std::uint64_t{1} << Level;
+            Block = Acc{};
+            InBlock = 0;
+        }
+
+        for (auto Level = 0; Level < 64; ++Level)
+        {
+            if (Filled & (std::uint64_t{1} << Level))
+                Block = Levels[Level] + Block;
+        }
+
+        return Block;
+    }
+
+    /// Sums values with Neumaier's compensation term.
+    template<typename Acc, typename I, typename S>
+    constexpr Acc SumKahan(I Begin, S End)
+    {
+        auto Result = Acc{};
+        auto Compensation = Acc{};
+
+        for (; Begin != End; ++Begin)
+        {
+            auto Value = static_cast<Acc>(*Begin);
+            auto Next = Result + Value;
+
+            if ((Result < 0 ? -Result : Result) >= (Value < 0 ? -Value : Value))
+                Compensation += (Result - Next) + Value;
+            else
+                Compensation += (Value - Next) + Result;
+
+            Result = Next;
+        }
+
+        return Result + Compensation;
+    }
+
+    /// Sums [Begin, End) into 'Acc' with the requested summation mode.
+    template<typename Acc, typename I, typename S>
+    constexpr Acc Sum(I Begin, S End, Summation Mode)
+    {
+        if constexpr (std::is_floating_point_v<Acc>)
+        {
+            if (Mode == Summation::Kahan)
+                return SumKahan<Acc>(Begin, End);
+
+            if (Mode == Summation::Pairwise)
+                return SumPairwise<Acc>(Begin, End);
+        }
+
+        if constexpr (std::contiguous_iterator<I> && std::sized_sentinel_for<S, I> && std::is_arithmetic_v<std::iter_value_t<I>>)
+        {
+            return SumContiguous<Acc>(std::to_address(Begin), static_cast<std::size_t>(End - Begin));
+        }
+        else
+        {
+            auto Add = [](Acc Total, auto&& Value){ return Total + static_cast<Acc>(Value); };
+            return Accumulate(Begin, End, Acc{}, Add);
+        }
+    }
+
+    /// Views whose elements parallel terminals can split by index.
+    template<typename V>
+    concept Splittable = std::ranges::random_access_range<V> && std::ranges::sized_range<V>;
+
+    /// Runs Emit(Value, Out) over grain-sized chunks of the view on the pool and concatenates each chunk's output in
+    /// order; views that can't be split by index are copied into a vector first.
+    template<typename R, std::ranges::input_range V, typename F>
+    std::vector<R> ParGather(V& View, ThreadPool& Pool, std::size_t Grain, F Emit)
+    {
+        if constexpr (!Splittable<V>)
+        {
+            auto Values = std::vector<std::ranges::range_value_t<V>>{};
+            for (auto&& Value : View)
+                Values.push_back(std::forward<decltype(Value)>(Value));
+
+            return ParGather<R>(Values, Pool, Grain, std::move(Emit));
+        }
+        else
+        {
+            using DifferenceType = std::ranges::range_difference_t<V>;
+
+            Grain = Grain ? Grain : Pool.Grain();
+
+            auto Begin = std::ranges::begin(View);
+            auto Size = std::ranges::size(View);
+            auto Chunks = std::vector<std::vector<R>>((Size + Grain - 1) / Grain);
+
+            Pool.ParallelFor(Size, [&](std::size_t First, std::size_t Last)
+            {
+                auto& Out = Chunks[First / Grain];
+                for (auto It = Begin + DifferenceType(First); It != Begin + DifferenceType(Last); ++It)
+                    Emit(*It, Out);
+            }, Grain);
+
+            auto Total = std::size_t{0};
+            for (auto& Chunk : Chunks)
+                Total += Chunk.size();
+
+            auto Result = std::vector<R>{};
+            Result.reserve(Total);
+            for (auto& Chunk : Chunks)
+                std::ranges::move(Chunk, std::back_inserter(Result));
+
+            return Result;
+        }
+    }
+
+    /// Sorts 'Values', splitting them across threads when the policy allows: each slice is sorted on its own thread,
+    /// then neighbouring runs are merged pairwise, with the merges of each round also running in parallel.
+    template<typename V, typename C>
+    void Sort(std::vector<V>& Values, C& Compare, const ExecutionPolicy& Policy)
+    {
+        auto Count = Values.size();
+        auto Slices = Policy.Workers == 1 ? 1 : SliceCount(Count, Policy);
+        if (Slices <= 1)
+        {
+            std::sort(Values.begin(), Values.end(), Compare);
+            return;
+        }
+
+        auto Bound = [&](std::size_t Slot){ return Values.begin() + static_cast<std::ptrdiff_t>(Count * Slot / Slices); };
+
+        ParallelFor(Count, Slices, Policy, [&](auto Slot, auto, auto){ std::sort(Bound(Slot), Bound(Slot + 1), Compare); });
+
+        for (auto Width = std::size_t{1}; Width < Slices; Width *= 2)
+        {
+            auto Pairs = (Slices + Width * 2 - 1) / (Width * 2);
+            ParallelFor(Pairs, Pairs, Policy, [&](auto Pair, auto, auto)
+            {
+                auto Left = Pair * Width * 2;
+                auto Middle = std::min(Left + Width, Slices);
+                auto Right = std::min(Left + Width * 2, Slices);
+                if (Middle < Right)
+                    std::inplace_merge(Bound(Left), Bound(Middle), Bound(Right), Compare);
+            });
+        }
+    }
+
+    /// Returns the first 'K' elements of [Begin, End) in 'Compare' order, using a bounded heap of 'K' elements
+    /// (O(n log k) time, O(k) memory) instead of sorting everything.
+    template<typename I, typename S, typename C>
+    auto TopK(I Begin, S End, std::size_t K, C& Compare)
+    {
+        using ValueType = std::iter_value_t<I>;
+
+        // A max-heap under 'Compare' keeps the kept element that sorts last on top, ready to be evicted
+        auto Heap = std::vector<ValueType>{};
+        Heap.reserve(K);
+        for (; K && Begin != End; ++Begin)
+        {
+            if (Heap.size() < K)
+            {
+                Heap.push_back(*Begin);
+                std::push_heap(Heap.begin(), Heap.end(), Compare);
+            }
+            else if (std::invoke(Compare, *Begin, Heap.front()))
+            {
+                std::pop_heap(Heap.begin(), Heap.end(), Compare);
+                Heap.back() = *Begin;
+                std::push_heap(Heap.begin(), Heap.end(), Compare);
+            }
+        }
+
+        std::sort_heap(Heap.begin(), Heap.end(), Compare);
+        return Heap;
+    }
+
+#if STREAM_PROFILE
+    /// Wraps a stage function so each call is counted into a profiled stage, timing and counting the allocations
+    /// of one call in every StageProfile::SampleEvery. 'Selects' stages (filters) count an output only when the call returns true.
+    template<typename F, bool Selects>
+    class ProfiledFunc
+    {
+    public:
+        ProfiledFunc() = default;
+        constexpr ProfiledFunc(F Func, Stream::StageProfile* Stage) : Func(std::move(Func)), Stage(Stage) {}
+
+        template<typename... A>
+        constexpr std::invoke_result_t<F&, A...> operator()(A&&... Args) { return Call(Func, std::forward<A>(Args)...); }
+
+        template<typename... A>
+        constexpr std::invoke_result_t<const F&, A...> operator()(A&&... Args) const { return Call(Func, std::forward<A>(Args)...); }
+
+    private:
+        template<typename G, typename... A>
+        constexpr std::invoke_result_t<G&, A...> Call(G& Target, A&&... Args) const
+        {
+            using ResultType = std::invoke_result_t<G&, A...>;
+
+            if (!Stage)
+                return std::invoke(Target, std::forward<A>(Args)...);
+
+            auto Sampled = Stage->In.fetch_add(1, std::memory_order_relaxed) % Stage->SampleEvery == 0;
+            auto Start = Sampled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+            auto Allocations = Stream::Profiler::ThreadAllocations();
+
+            ResultType Result = std::invoke(Target, std::forward<A>(Args)...);
+
+            if (Sampled)
+            {
+                auto Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+                Stage->Samples.fetch_add(1, std::memory_order_relaxed);
+                Stage->Nanoseconds.fetch_add(static_cast<std::uint64_t>(Elapsed), std::memory_order_relaxed);
+                Stage->Allocations.fetch_add(Stream::Profiler::ThreadAllocations() - Allocations, std::memory_order_relaxed);
+            }
+
+            if constexpr (Selects)
+            {
+                if (static_cast<bool>(Result))
+                    Stage->Out.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                Stage->Out.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return std::forward<ResultType>(Result);
+        }
+
+        F Func{};
+        Stream::StageProfile* Stage = nullptr;
+    };
+
+    template<typename F>
+    inline constexpr bool IsProfiled = false;
+
+    template<typename F, bool Selects>
+    inline constexpr bool IsProfiled<ProfiledFunc<F, Selects>> = true;
+
+    /// Registers a stage with the policy's profiler, if one is attached (never during constant evaluation).
+    constexpr Stream::StageProfile* AddStage(const ExecutionPolicy& Policy, std::string_view Kind, bool InFromPrevious = false)
+    {
+        if (std::is_constant_evaluated() || !Policy.Profiler)
+            return nullptr;
+
+        return &Policy.Profiler->AddStage(std::string(Kind), InFromPrevious);
+    }
+
+    /// Wraps a stage function into a new stage of the policy's profiler (a pass-through when none is attached).
+    template<bool Selects, typename F>
+    constexpr auto Profiled(F Func, const ExecutionPolicy& Policy, std::string_view Kind)
+    {
+        return ProfiledFunc<F, Selects>{std::move(Func), AddStage(Policy, Kind)};
+    }
+
+    /// Element type a counting pass-through yields: references to stored elements, copies of temporaries.
+    template<typename R>
+    using PassedType = std::conditional_t<std::is_lvalue_reference_v<R>, R, std::remove_cvref_t<R>>;
+#endif
+
+    /// Holds a callable so views stay assignable even when the callable (e.g. a capturing lambda) is not.
+    template<typename F>
+    class Box
+    {
+    public:
+        constexpr Box() = default;
+        constexpr explicit Box(F Value) : Value(std::move(Value)) {}
+
+        constexpr Box(const Box&) = default;
+        constexpr Box(Box&&) = default;
+
+        constexpr Box& operator=(const Box& Other)
+        {
+            if (this != &Other)
+            {
+                Value.reset();
+                if (Other.Value)
+                    Value.emplace(*Other.Value);
+            }
+            return *this;
+        }
+
+        constexpr Box& operator=(Box&& Other)
+        {
+            if (this != &Other)
+            {
+                Value.reset();
+                if (Other.Value)
+                    Value.emplace(std::move(*Other.Value));
+            }
+            return *this;
+        }
+
+        constexpr F& operator*() { return *Value; }
+        constexpr const F& operator*() const { return *Value; }
+
+    private:
+        std::optional<F> Value{};
+    };
+
+    template<typename Key>
+    concept Hashable = std::equality_comparable<Key> && requires(const Key& Value)
+    {
+        { std::hash<Key>{}(Value) } -> std::convertible_to<std::size_t>;
+    };
+
+    /// Spreads a hash over all bits so power-of-two tables don't cluster on patterned keys (Fibonacci hashing).
+    constexpr std::uint64_t MixHash(std::uint64_t Hash)
+    {
+        return Hash * 0x9E3779B97F4A7C15ull;
+    }
+
+    /// Open addressing hash set with linear probing, kept at most half full.
+    template<Hashable Key>
+    class FlatSet
+    {
+    public:
+        constexpr explicit FlatSet(std::size_t CapacityHint = 0)
+        {
+            Rehash(std::max<std::size_t>(CapacityHint * 2, 16));
+        }
+
+        /// Inserts the key and returns true if it was not present yet.
+        constexpr bool Insert(const Key& Value)
+        {
+            if ((Count + 1) * 2 > Slots.size())
+                Rehash(Slots.size() * 2);
+
+            for (auto Index = Probe(Value);; Index = (Index + 1) & (Slots.size() - 1))
+            {
+                if (!Slots[Index])
+                {
+                    Slots[Index].emplace(Value);
+                    ++Count;
+                    return true;
+                }
+
+                if (*Slots[Index] == Value)
+                    return false;
+            }
+        }
+
+        constexpr std::size_t Size() const { return Count; }
+
+    private:
+        constexpr std::size_t Probe(const Key& Value) const
+        {
+            return static_cast<std::size_t>(MixHash(std::hash<Key>{}(Value)) >> (64 - Bits));
+        }
+
+        constexpr void Rehash(std::size_t Capacity)
+        {
+            auto NewSize = std::size_t{1};
+            Bits = 0;
+            while (NewSize < Capacity)
+            {
+                NewSize <<= 1;
+                ++Bits;
+            }
+
+            auto OldSlots = std::exchange(Slots, std::vector<std::optional<Key>>(NewSize));
+            for (auto& Slot : OldSlots)
+            {
+                if (!Slot)
+                    continue;
+
+                auto Index = Probe(*Slot);
+                while (Slots[Index])
+                    Index = (Index + 1) & (Slots.size() - 1);
+
+                Slots[Index].emplace(std::move(*Slot));
+            }
+        }
+
+        std::vector<std::optional<Key>> Slots{};
+        std::size_t Count = 0;
+        int Bits = 0;
+    };
+
+    /// Ordered fallback for keys that have operator< but no std::hash specialization.
+    template<std::totally_ordered Key>
+    class OrderedSet
+    {
+    public:
+        explicit OrderedSet(std::size_t = 0) {}
+
+        bool Insert(const Key& Value) { return Keys.insert(Value).second; }
+        std::size_t Size() const { return Keys.size(); }
+
+    private:
+        std::set<Key> Keys{};
+    };
+
+    template<typename Key>
+    struct SeenSetFor;
+
+    template<typename Key> requires Hashable<Key>
+    struct SeenSetFor<Key> { using Type = FlatSet<Key>; };
+
+    template<typename Key> requires (!Hashable<Key> && std::totally_ordered<Key>)
+    struct SeenSetFor<Key> { using Type = OrderedSet<Key>; };
+
+    /// Set used to remember keys already emitted: hashed when possible, ordered otherwise.
+    template<typename Key>
+    using SeenSet = typename SeenSetFor<Key>::Type;
+
+    /// Lazily yields the elements whose key has not been seen before, in a single pass.
+    template<std::ranges::input_range V, typename F>
+        requires std::ranges::view<V>
+    class UniqView : public std::ranges::view_interface<UniqView<V, F>>
+    {
+        using KeyType = std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<V>>>;
+
+        class Sentinel;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr Iterator(UniqView* Parent, std::ranges::iterator_t<V> Current) : Parent(Parent), Current(std::move(Current))
+            {
+                Satisfy();
+            }
+
+            constexpr decltype(auto) operator*() const { return *Current; }
+
+            constexpr Iterator& operator++()
+            {
+                ++Current;
+                Satisfy();
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            friend constexpr bool operator==(const Iterator& It, const Sentinel& End) { return It.Current == End.End; }
+
+        private:
+            constexpr void Satisfy()
+            {
+                while (Current != std::ranges::end(Parent->Base) && !Parent->Seen.Insert(std::invoke(*Parent->KeyFunc, *Current)))
+                    ++Current;
+            }
+
+            UniqView* Parent = nullptr;
+            std::ranges::iterator_t<V> Current{};
+        };
+
+        class Sentinel
+        {
+        public:
+            std::ranges::sentinel_t<V> End{};
+        };
+
+    public:
+        UniqView() = default;
+        constexpr UniqView(V Base, F KeyFunc, std::size_t CapacityHint = 0)
+            : Base(std::move(Base)), KeyFunc(std::move(KeyFunc)), CapacityHint(CapacityHint), Seen(CapacityHint) {}
+
+        /// Starts a new pass; the seen set is reset so the view can be iterated again.
+        constexpr auto begin()
+        {
+            if (Seen.Size() != 0)
+                Seen = SeenSet<KeyType>(CapacityHint);
+            return Iterator{this, std::ranges::begin(Base)};
+        }
+
+        constexpr auto end() { return Sentinel{std::ranges::end(Base)}; }
+
+    private:
+        V Base{};
+        Box<F> KeyFunc{};
+        std::size_t CapacityHint = 0;
+        SeenSet<KeyType> Seen{};
+    };
+
+    template<typename R, typename F>
+    UniqView(R&&, F, std::size_t) -> UniqView<std::views::all_t<R>, F>;
+
+    template<bool Const, typename V>
+    using MaybeConst = std::conditional_t<Const, const V, V>;
+
+    /// Pairs each element with a counter carried by the iterator, so each step is O(1) on any view.
+    template<std::ranges::input_range V, std::integral I>
+        requires std::ranges::view<V>
+    class EnumerateView : public std::ranges::view_interface<EnumerateView<V, I>>
+    {
+        template<bool Const>
+        class Iterator
+        {
+            using Base = MaybeConst<Const, V>;
+
+        public:
+            using iterator_concept = std::conditional_t<std::ranges::forward_range<Base>, std::forward_iterator_tag, std::input_iterator_tag>;
+            using value_type = std::pair<I, std::ranges::range_value_t<Base>>;
+            using difference_type = std::ranges::range_difference_t<Base>;
+
+            Iterator() = default;
+            constexpr Iterator(std::ranges::iterator_t<Base> Current, I Index) : Current(std::move(Current)), Index(Index) {}
+
+            constexpr value_type operator*() const { return value_type(Index, *Current); }
+
+            constexpr Iterator& operator++()
+            {
+                ++Current;
+                ++Index;
+                return *this;
+            }
+
+            constexpr void operator++(int) requires (!std::ranges::forward_range<Base>) { ++*this; }
+
+            constexpr Iterator operator++(int) requires std::ranges::forward_range<Base>
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right)
+                requires std::equality_comparable<std::ranges::iterator_t<Base>>
+            {
+                return Left.Current == Right.Current;
+            }
+
+            friend constexpr bool operator==(const Iterator& It, const std::ranges::sentinel_t<Base>& End) { return It.Current == End; }
+
+        private:
+            std::ranges::iterator_t<Base> Current{};
+            I Index{};
+        };
+
+    public:
+        EnumerateView() = default;
+        constexpr EnumerateView(V Base, I Offset) : Base(std::move(Base)), Offset(Offset) {}
+
+        constexpr auto begin() { return Iterator<false>{std::ranges::begin(Base), Offset}; }
+        constexpr auto begin() const requires std::ranges::range<const V> { return Iterator<true>{std::ranges::begin(Base), Offset}; }
+
+        constexpr auto end() { return std::ranges::end(Base); }
+        constexpr auto end() const requires std::ranges::range<const V> { return std::ranges::end(Base); }
+
+        constexpr auto size() requires std::ranges::sized_range<V> { return std::ranges::size(Base); }
+        constexpr auto size() const requires std::ranges::sized_range<const V> { return std::ranges::size(Base); }
+
+    private:
+        V Base{};
+        I Offset{};
+    };
+
+    template<typename R, typename I>
+    EnumerateView(R&&, I) -> EnumerateView<std::views::all_t<R>, I>;
+
+    /// Calls Func(std::integral_constant<std::size_t, I>{}) for the I in [0, N) equal to the runtime Index.
+    template<std::size_t N, std::size_t I = 0, typename F>
+    constexpr decltype(auto) AtIndex(std::size_t Index, F&& Func)
+    {
+        if constexpr (I + 1 < N)
+        {
+            if (Index != I)
+                return AtIndex<N, I + 1>(Index, std::forward<F>(Func));
+        }
+
+        return Func(std::integral_constant<std::size_t, I>{});
+    }
+
+    /// Views a stream or range given to a multi-source stage: streams hand over their view, and ranges are viewed
+    /// the way Stream::of does.
+    template<typename S>
+    constexpr auto ViewOf(S&& Source)
+    {
+        using R = std::remove_cvref_t<S>;
+
+        if constexpr (requires { Source.View; Source.Policy; })
+            return std::forward<S>(Source).View;
+        else if constexpr (std::is_lvalue_reference_v<S> && std::ranges::contiguous_range<S> && std::ranges::sized_range<S> && !std::ranges::view<R>)
+            return std::span(Source);
+        else
+            return std::views::all(std::forward<S>(Source));
+    }
+
+    /// Walks views in lockstep, yielding a std::tuple of their elements until the shortest ends (C++20 stand-in for
+    /// std::views::zip). Random access and sized when all of the views are. Elements are tuples of the views'
+    /// references and values are tuples of their values, so collecting or sorting copies rather than aliasing them.
+    template<std::ranges::input_range... V>
+        requires (sizeof...(V) > 0) && (std::ranges::view<V> && ...)
+    class ZipView : public std::ranges::view_interface<ZipView<V...>>
+    {
+        template<bool Const>
+        static constexpr bool RandomAccess = (std::ranges::random_access_range<MaybeConst<Const, V>> && ...);
+
+        template<bool Const>
+        static constexpr bool Bidirectional = (std::ranges::bidirectional_range<MaybeConst<Const, V>> && ...);
+
+        template<bool Const>
+        static constexpr bool Forward = (std::ranges::forward_range<MaybeConst<Const, V>> && ...);
+
+        template<bool Const>
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::conditional_t<RandomAccess<Const>, std::random_access_iterator_tag,
+                std::conditional_t<Bidirectional<Const>, std::bidirectional_iterator_tag,
+                std::conditional_t<Forward<Const>, std::forward_iterator_tag, std::input_iterator_tag>>>;
+            using value_type = std::tuple<std::ranges::range_value_t<MaybeConst<Const, V>>...>;
+            using reference = TupleRef<std::ranges::range_reference_t<MaybeConst<Const, V>>...>;
+            using difference_type = std::common_type_t<std::ranges::range_difference_t<MaybeConst<Const, V>>...>;
+
+            Iterator() = default;
+            constexpr explicit Iterator(std::tuple<std::ranges::iterator_t<MaybeConst<Const, V>>...> Current) : Current(std::move(Current)) {}
+
+            constexpr reference operator*() const
+            {
+                return std::apply([](const auto&... It){ return reference(*It...); }, Current);
+            }
+
+            constexpr reference operator[](difference_type Offset) const requires RandomAccess<Const> { return *(*this + Offset); }
+
+            constexpr Iterator& operator++()
+            {
+                std::apply([](auto&... It){ (++It, ...); }, Current);
+                return *this;
+            }
+
+            constexpr void operator++(int) requires (!Forward<Const>) { ++*this; }
+
+            constexpr Iterator operator++(int) requires Forward<Const>
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator--() requires Bidirectional<Const>
+            {
+                std::apply([](auto&... It){ (--It, ...); }, Current);
+                return *this;
+            }
+
+            constexpr Iterator operator--(int) requires Bidirectional<Const>
+            {
+                auto Previous = *this;
+                --*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator+=(difference_type Offset) requires RandomAccess<Const>
+            {
+                std::apply([Offset](auto&... It){ ((It += static_cast<std::iter_difference_t<std::remove_cvref_t<decltype(It)>>>(Offset)), ...); }, Current);
+                return *this;
+            }
+
+            constexpr Iterator& operator-=(difference_type Offset) requires RandomAccess<Const> { return *this += -Offset; }
+
+            friend constexpr Iterator operator+(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator+(difference_type Offset, Iterator It) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator-(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It -= Offset; }
+
+            // All iterators advance together, so the first one stands for the tuple
+            friend constexpr difference_type operator-(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return static_cast<difference_type>(std::get<0>(Left.Current) - std::get<0>(Right.Current));
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) requires Forward<Const>
+            {
+                return std::get<0>(Left.Current) == std::get<0>(Right.Current);
+            }
+
+            friend constexpr auto operator<=>(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return std::get<0>(Left.Current) <=> std::get<0>(Right.Current);
+            }
+
+            /// Returns the underlying iterators.
+            constexpr const auto& Iterators() const { return Current; }
+
+        private:
+            std::tuple<std::ranges::iterator_t<MaybeConst<Const, V>>...> Current{};
+        };
+
+        template<bool Const>
+        class Sentinel
+        {
+        public:
+            Sentinel() = default;
+            constexpr explicit Sentinel(std::tuple<std::ranges::sentinel_t<MaybeConst<Const, V>>...> End) : End(std::move(End)) {}
+
+            // The zip ends as soon as any of its views does
+            friend constexpr bool operator==(const Iterator<Const>& It, const Sentinel& Last)
+            {
+                return [&]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    return ((std::get<I>(It.Iterators()) == std::get<I>(Last.End)) || ...);
+                }(std::index_sequence_for<V...>{});
+            }
+
+        private:
+            std::tuple<std::ranges::sentinel_t<MaybeConst<Const, V>>...> End{};
+        };
+
+        template<bool Const, typename Self>
+        static constexpr auto Begin(Self& This)
+        {
+            return Iterator<Const>{std::apply([](auto&... Base){ return std::tuple{std::ranges::begin(Base)...}; }, This.Bases)};
+        }
+
+        template<bool Const, typename Self>
+        static constexpr auto End(Self& This)
+        {
+            // Random access, sized zips end at the shortest length, so the view is a common range
+            if constexpr (RandomAccess<Const> && (std::ranges::sized_range<MaybeConst<Const, V>> && ...))
+                return Begin<Const>(This) + static_cast<typename Iterator<Const>::difference_type>(This.size());
+            else
+                return Sentinel<Const>{std::apply([](auto&... Base){ return std::tuple{std::ranges::end(Base)...}; }, This.Bases)};
+        }
+
+    public:
+        ZipView() = default;
+        constexpr explicit ZipView(V... Bases) : Bases(std::move(Bases)...) {}
+
+        constexpr auto begin() { return Begin<false>(*this); }
+        constexpr auto begin() const requires (std::ranges::range<const V> && ...) { return Begin<true>(*this); }
+
+        constexpr auto end() { return End<false>(*this); }
+        constexpr auto end() const requires (std::ranges::range<const V> && ...) { return End<true>(*this); }
+
+        constexpr std::size_t size() requires (std::ranges::sized_range<V> && ...)
+        {
+            return std::apply([](auto&... Base){ return std::min({static_cast<std::size_t>(std::ranges::size(Base))...}); }, Bases);
+        }
+
+        constexpr std::size_t size() const requires (std::ranges::sized_range<const V> && ...)
+        {
+            return std::apply([](auto&... Base){ return std::min({static_cast<std::size_t>(std::ranges::size(Base))...}); }, Bases);
+        }
+
+    private:
+        std::tuple<V...> Bases{};
+    };
+
+    template<typename... R>
+    ZipView(R&&...) -> ZipView<std::views::all_t<R>...>;
+
+    /// Yields all elements of the first view, then of the next, and so on. Sized when all of the views are, and
+    /// random access when they all are both.
+    template<std::ranges::input_range... V>
+        requires (sizeof...(V) > 0) && (std::ranges::view<V> && ...)
+    class ConcatView : public std::ranges::view_interface<ConcatView<V...>>
+    {
+        template<bool Const>
+        static constexpr bool RandomAccess = ((std::ranges::random_access_range<MaybeConst<Const, V>> && std::ranges::sized_range<MaybeConst<Const, V>>) && ...);
+
+        template<bool Const>
+        static constexpr bool Forward = (std::ranges::forward_range<MaybeConst<Const, V>> && ...);
+
+        template<bool Const>
+        class Iterator
+        {
+            using Reference = std::common_reference_t<std::ranges::range_reference_t<MaybeConst<Const, V>>...>;
+
+        public:
+            using iterator_concept = std::conditional_t<RandomAccess<Const>, std::random_access_iterator_tag,
+                std::conditional_t<Forward<Const>, std::forward_iterator_tag, std::input_iterator_tag>>;
+            using value_type = std::common_type_t<std::ranges::range_value_t<MaybeConst<Const, V>>...>;
+            using difference_type = std::common_type_t<std::ranges::range_difference_t<MaybeConst<Const, V>>...>;
+
+            Iterator() = default;
+            constexpr explicit Iterator(MaybeConst<Const, ConcatView>* Parent)
+                : Parent(Parent), Current(std::in_place_index<0>, std::ranges::begin(std::get<0>(Parent->Bases)))
+            {
+                Satisfy();
+            }
+
+            constexpr Reference operator*() const { return std::visit([](const auto& It) -> Reference { return *It; }, Current); }
+
+            constexpr Reference operator[](difference_type Offset) const requires RandomAccess<Const> { return *(*this + Offset); }
+
+            constexpr Iterator& operator++()
+            {
+                std::visit([](auto& It){ ++It; }, Current);
+                Satisfy();
+                return *this;
+            }
+
+            constexpr void operator++(int) requires (!Forward<Const>) { ++*this; }
+
+            constexpr Iterator operator++(int) requires Forward<Const>
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator--() requires RandomAccess<Const> { return *this -= 1; }
+
+            constexpr Iterator operator--(int) requires RandomAccess<Const>
+            {
+                auto Previous = *this;
+                --*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator+=(difference_type Offset) requires RandomAccess<Const>
+            {
+                Seek(Position() + Offset);
+                return *this;
+            }
+
+            constexpr Iterator& operator-=(difference_type Offset) requires RandomAccess<Const> { return *this += -Offset; }
+
+            friend constexpr Iterator operator+(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator+(difference_type Offset, Iterator It) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator-(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It -= Offset; }
+
+            friend constexpr difference_type operator-(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return Left.Position() - Right.Position();
+            }
+
+            friend constexpr difference_type operator-(std::default_sentinel_t, const Iterator& It) requires RandomAccess<Const>
+            {
+                return static_cast<difference_type>(It.Parent->size()) - It.Position();
+            }
+
+            friend constexpr difference_type operator-(const Iterator& It, std::default_sentinel_t End) requires RandomAccess<Const> { return -(End - It); }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) requires Forward<Const> { return Left.Current == Right.Current; }
+
+            friend constexpr auto operator<=>(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return Left.Position() <=> Right.Position();
+            }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.AtEnd(); }
+
+        private:
+            constexpr bool AtEnd() const
+            {
+                constexpr auto Last = sizeof...(V) - 1;
+                return Current.index() == Last && std::get<Last>(Current) == std::ranges::end(std::get<Last>(Parent->Bases));
+            }
+
+            // Moves on to the next view while the current one is exhausted
+            template<std::size_t I = 0>
+            constexpr void Satisfy()
+            {
+                if constexpr (I + 1 < sizeof...(V))
+                {
+                    if (Current.index() == I)
+                    {
+                        if (std::get<I>(Current) != std::ranges::end(std::get<I>(Parent->Bases)))
+                            return;
+
+                        Current.template emplace<I + 1>(std::ranges::begin(std::get<I + 1>(Parent->Bases)));
+                    }
+                    Satisfy<I + 1>();
+                }
+            }
+
+            // Index of the current element across all of the views
+            constexpr difference_type Position() const
+            {
+                return AtIndex<sizeof...(V)>(Current.index(), [this](auto I)
+                {
+                    auto Offset = [this]<std::size_t... J>(std::index_sequence<J...>)
+                    {
+                        return (difference_type{0} + ... + static_cast<difference_type>(std::ranges::size(std::get<J>(Parent->Bases))));
+                    }(std::make_index_sequence<decltype(I)::value>{});
+
+                    return Offset + static_cast<difference_type>(std::get<I>(Current) - std::ranges::begin(std::get<I>(Parent->Bases)));
+                });
+            }
+
+            // Moves to the element at Position, skipping empty views as Satisfy does; the last view takes what is left
+            template<std::size_t I = 0>
+            constexpr void Seek(difference_type Position)
+            {
+                auto& Base = std::get<I>(Parent->Bases);
+                if constexpr (I + 1 < sizeof...(V))
+                {
+                    auto Size = static_cast<difference_type>(std::ranges::size(Base));
+                    if (Position >= Size)
+                        return Seek<I + 1>(Position - Size);
+                }
+
+                Current.template emplace<I>(std::ranges::begin(Base) + static_cast<std::ranges::range_difference_t<decltype(Base)>>(Position));
+            }
+
+            MaybeConst<Const, ConcatView>* Parent = nullptr;
+            std::variant<std::ranges::iterator_t<MaybeConst<Const, V>>...> Current{};
+        };
+
+    public:
+        ConcatView() = default;
+        constexpr explicit ConcatView(V... Bases) : Bases(std::move(Bases)...) {}
+
+        constexpr auto begin() { return Iterator<false>{this}; }
+        constexpr auto begin() const requires (std::ranges::input_range<const V> && ...) { return Iterator<true>{this}; }
+
+        constexpr auto end() { return std::default_sentinel; }
+        constexpr auto end() const requires (std::ranges::input_range<const V> && ...) { return std::default_sentinel; }
+
+        constexpr std::size_t size() requires (std::ranges::sized_range<V> && ...)
+        {
+            return std::apply([](auto&... Base){ return (static_cast<std::size_t>(std::ranges::size(Base)) + ...); }, Bases);
+        }
+
+        constexpr std::size_t size() const requires (std::ranges::sized_range<const V> && ...)
+        {
+            return std::apply([](auto&... Base){ return (static_cast<std::size_t>(std::ranges::size(Base)) + ...); }, Bases);
+        }
+
+    private:
+        std::tuple<V...> Bases{};
+    };
+
+    template<typename... R>
+    ConcatView(R&&...) -> ConcatView<std::views::all_t<R>...>;
+
+    /// Takes one element from each view in turn, skipping views once they run out, until all of them have.
+    /// Sized when all of the views are, and random access when they all are both.
+    template<std::ranges::input_range... V>
+        requires (sizeof...(V) > 0) && (std::ranges::view<V> && ...)
+    class InterleaveView : public std::ranges::view_interface<InterleaveView<V...>>
+    {
+        static constexpr auto Count = sizeof...(V);
+
+        template<bool Const>
+        static constexpr bool RandomAccess = ((std::ranges::random_access_range<MaybeConst<Const, V>> && std::ranges::sized_range<MaybeConst<Const, V>>) && ...);
+
+        template<bool Const>
+        static constexpr bool Forward = (std::ranges::forward_range<MaybeConst<Const, V>> && ...);
+
+        template<bool Const>
+        class Iterator
+        {
+            using Reference = std::common_reference_t<std::ranges::range_reference_t<MaybeConst<Const, V>>...>;
+
+        public:
+            using iterator_concept = std::conditional_t<RandomAccess<Const>, std::random_access_iterator_tag,
+                std::conditional_t<Forward<Const>, std::forward_iterator_tag, std::input_iterator_tag>>;
+            using value_type = std::common_type_t<std::ranges::range_value_t<MaybeConst<Const, V>>...>;
+            using difference_type = std::common_type_t<std::ranges::range_difference_t<MaybeConst<Const, V>>...>;
+
+            Iterator() = default;
+            constexpr explicit Iterator(MaybeConst<Const, InterleaveView>* Parent)
+                : Parent(Parent), Current(std::apply([](auto&... Base){ return std::tuple{std::ranges::begin(Base)...}; }, Parent->Bases))
+            {
+                Pass();
+            }
+
+            constexpr Reference operator*() const
+            {
+                return AtIndex<Count>(Turn, [this](auto I) -> Reference { return *std::get<I>(Current); });
+            }
+
+            constexpr Reference operator[](difference_type Offset) const requires RandomAccess<Const> { return *(*this + Offset); }
+
+            constexpr Iterator& operator++()
+            {
+                AtIndex<Count>(Turn, [this](auto I){ ++std::get<I>(Current); });
+                Pass();
+                return *this;
+            }
+
+            constexpr void operator++(int) requires (!Forward<Const>) { ++*this; }
+
+            constexpr Iterator operator++(int) requires Forward<Const>
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator--() requires RandomAccess<Const> { return *this -= 1; }
+
+            constexpr Iterator operator--(int) requires RandomAccess<Const>
+            {
+                auto Previous = *this;
+                --*this;
+                return Previous;
+            }
+
+            constexpr Iterator& operator+=(difference_type Offset) requires RandomAccess<Const>
+            {
+                Seek(Position() + Offset);
+                return *this;
+            }
+
+            constexpr Iterator& operator-=(difference_type Offset) requires RandomAccess<Const> { return *this += -Offset; }
+
+            friend constexpr Iterator operator+(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator+(difference_type Offset, Iterator It) requires RandomAccess<Const> { return It += Offset; }
+            friend constexpr Iterator operator-(Iterator It, difference_type Offset) requires RandomAccess<Const> { return It -= Offset; }
+
+            friend constexpr difference_type operator-(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return Left.Position() - Right.Position();
+            }
+
+            friend constexpr difference_type operator-(std::default_sentinel_t, const Iterator& It) requires RandomAccess<Const>
+            {
+                return static_cast<difference_type>(It.Parent->size()) - It.Position();
+            }
+
+            friend constexpr difference_type operator-(const Iterator& It, std::default_sentinel_t End) requires RandomAccess<Const> { return -(End - It); }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) requires Forward<Const>
+            {
+                return Left.Turn == Right.Turn && Left.Current == Right.Current;
+            }
+
+            friend constexpr auto operator<=>(const Iterator& Left, const Iterator& Right) requires RandomAccess<Const>
+            {
+                return Left.Position() <=> Right.Position();
+            }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Turn == Count; }
+
+        private:
+            // Hands the turn to the next view that still has elements, or marks the end once none has
+            constexpr void Pass()
+            {
+                for (std::size_t Step = 0; Step < Count; ++Step)
+                {
+                    Turn = (Turn + 1) % Count;
+                    if (!AtIndex<Count>(Turn, [this](auto I){ return std::get<I>(Current) == std::ranges::end(std::get<I>(Parent->Bases)); }))
+                        return;
+                }
+                Turn = Count;
+            }
+
+            // Each view's iterator sits on the next element it yields, so the elements passed are what they consumed
+            constexpr difference_type Position() const
+            {
+                return [this]<std::size_t... I>(std::index_sequence<I...>)
+                {
+                    return (difference_type{0} + ... + static_cast<difference_type>(std::get<I>(Current) - std::ranges::begin(std::get<I>(Parent->Bases))));
+                }(std::index_sequence_for<V...>{});
+            }
+
+            // Moves to the element at Position: finds the number of full rounds before it, where each view yields
+            // until it runs out, then the view among those still going whose turn it is
+            constexpr void Seek(difference_type Position)
+            {
+                auto Sizes = std::apply([](auto&... Base){ return std::array{static_cast<difference_type>(std::ranges::size(Base))...}; }, Parent->Bases);
+                auto Consumed = [&Sizes](difference_type Rounds)
+                {
+                    auto Total = difference_type{0};
+                    for (auto Size : Sizes)
+                        Total += std::min(Size, Rounds);
+                    return Total;
+                };
+
+                auto Low = difference_type{0};
+                auto High = std::ranges::max(Sizes);
+                while (Low < High)
+                {
+                    auto Middle = Low + (High - Low + 1) / 2;
+                    if (Consumed(Middle) <= Position)
+                        Low = Middle;
+                    else
+                        High = Middle - 1;
+                }
+
+                auto Remaining = Position - Consumed(Low);
+                Turn = Count;
+                for (std::size_t Index = 0; Index < Count; ++Index)
+                {
+                    // Views still going ahead of the one whose turn it is have yielded their element of this round
+                    auto Taken = std::min(Sizes[Index], Low);
+                    if (Sizes[Index] > Low && Turn == Count)
+                    {
+                        if (Remaining == 0)
+                            Turn = Index;
+                        else
+                        {
+                            --Remaining;
+                            ++Taken;
+                        }
+                    }
+
+                    AtIndex<Count>(Index, [&](auto I)
+                    {
+                        auto& Base = std::get<I>(Parent->Bases);
+                        std::get<I>(Current) = std::ranges::begin(Base) + static_cast<std::ranges::range_difference_t<decltype(Base)>>(Taken);
+                    });
+                }
+            }
+
+            MaybeConst<Const, InterleaveView>* Parent = nullptr;
+            std::tuple<std::ranges::iterator_t<MaybeConst<Const, V>>...> Current{};
+            std::size_t Turn = Count - 1;
+        };
+
+    public:
+        InterleaveView() = default;
+        constexpr explicit InterleaveView(V... Bases) : Bases(std::move(Bases)...) {}
+
+        constexpr auto begin() { return Iterator<false>{this}; }
+        constexpr auto begin() const requires (std::ranges::input_range<const V> && ...) { return Iterator<true>{this}; }
+
+        constexpr auto end() { return std::default_sentinel; }
+        constexpr auto end() const requires (std::ranges::input_range<const V> && ...) { return std::default_sentinel; }
+
+        constexpr std::size_t size() requires (std::ranges::sized_range<V> && ...)
+        {
+            return std::apply([](auto&... Base){ return (static_cast<std::size_t>(std::ranges::size(Base)) + ...); }, Bases);
+        }
+
+        constexpr std::size_t size() const requires (std::ranges::sized_range<const V> && ...)
+        {
+            return std::apply([](auto&... Base){ return (static_cast<std::size_t>(std::ranges::size(Base)) + ...); }, Bases);
+        }
+
+    private:
+        std::tuple<V...> Bases{};
+    };
+
+    template<typename... R>
+    InterleaveView(R&&...) -> InterleaveView<std::views::all_t<R>...>;
+
+    /// Splits the view into subranges of 'Count' elements, advancing a single iterator (C++20 stand-in for std::views::chunk).
+    template<std::ranges::forward_range V>
+        requires std::ranges::view<V>
+    class ChunkView : public std::ranges::view_interface<ChunkView<V>>
+    {
+        using DifferenceType = std::ranges::range_difference_t<V>;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = std::ranges::subrange<std::ranges::iterator_t<V>>;
+            using difference_type = DifferenceType;
+
+            Iterator() = default;
+            constexpr Iterator(std::ranges::iterator_t<V> Current, std::ranges::sentinel_t<V> End, DifferenceType Count)
+                : Current(Current), Next(std::ranges::next(Current, Count, End)), End(End), Count(Count) {}
+
+            constexpr value_type operator*() const { return {Current, Next}; }
+
+            constexpr Iterator& operator++()
+            {
+                Current = Next;
+                Next = std::ranges::next(Current, Count, End);
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) { return Left.Current == Right.Current; }
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Current == It.End; }
+
+        private:
+            std::ranges::iterator_t<V> Current{};
+            std::ranges::iterator_t<V> Next{};
+            std::ranges::sentinel_t<V> End{};
+            DifferenceType Count = 0;
+        };
+
+    public:
+        ChunkView() = default;
+        constexpr ChunkView(V Base, DifferenceType Count) : Base(std::move(Base)), Count(Count) {}
+
+        constexpr auto begin() { return Iterator{std::ranges::begin(Base), std::ranges::end(Base), Count}; }
+        constexpr auto end() { return std::default_sentinel; }
+
+        constexpr auto size() requires std::ranges::sized_range<V>
+        {
+            return (std::ranges::size(Base) + Count - 1) / Count;
+        }
+
+    private:
+        V Base{};
+        DifferenceType Count = 0;
+    };
+
+    template<typename R, typename N>
+    ChunkView(R&&, N) -> ChunkView<std::views::all_t<R>>;
+
+    /// Splits an input-only view into vectors of 'Count' elements, reading each chunk into one reused buffer.
+    template<std::ranges::input_range V>
+        requires std::ranges::view<V>
+    class InputChunkView : public std::ranges::view_interface<InputChunkView<V>>
+    {
+        using DifferenceType = std::ranges::range_difference_t<V>;
+        using ChunkType = std::vector<std::ranges::range_value_t<V>>;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = ChunkType;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            constexpr explicit Iterator(InputChunkView* Parent) : Parent(Parent) {}
+
+            constexpr const ChunkType& operator*() const { return Parent->Chunk; }
+
+            constexpr Iterator& operator++()
+            {
+                Parent->Fill();
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Done(); }
+
+        private:
+            constexpr bool Done() const { return Parent->Chunk.empty(); }
+
+            InputChunkView* Parent = nullptr;
+        };
+
+    public:
+        InputChunkView() = default;
+        constexpr InputChunkView(V Base, DifferenceType Count) : Base(std::move(Base)), Count(Count) {}
+
+        constexpr auto begin()
+        {
+            Current.emplace(std::ranges::begin(Base));
+            Chunk.reserve(static_cast<std::size_t>(Count));
+            Fill();
+            return Iterator{this};
+        }
+
+        constexpr auto end() { return std::default_sentinel; }
+
+        constexpr auto size() requires std::ranges::sized_range<V>
+        {
+            return (std::ranges::size(Base) + Count - 1) / Count;
+        }
+
+    private:
+        constexpr void Fill()
+        {
+            Chunk.clear();
+            for (auto& It = *Current; It != std::ranges::end(Base) && static_cast<DifferenceType>(Chunk.size()) < Count; ++It)
+                Chunk.push_back(*It);
+        }
+
+        V Base{};
+        DifferenceType Count = 0;
+        std::optional<std::ranges::iterator_t<V>> Current{};
+        ChunkType Chunk{};
+    };
+
+    template<typename R, typename N>
+    InputChunkView(R&&, N) -> InputChunkView<std::views::all_t<R>>;
+
+    /// Splits the view between adjacent elements for which the predicate returns false (C++20 stand-in for std::views::chunk_by).
+    template<std::ranges::forward_range V, typename F>
+        requires std::ranges::view<V>
+    class ChunkByView : public std::ranges::view_interface<ChunkByView<V, F>>
+    {
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = std::ranges::subrange<std::ranges::iterator_t<V>>;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr Iterator(ChunkByView* Parent, std::ranges::iterator_t<V> Current)
+                : Parent(Parent), Current(Current), Next(Parent->FindNext(Current)) {}
+
+            constexpr value_type operator*() const { return {Current, Next}; }
+
+            constexpr Iterator& operator++()
+            {
+                Current = Next;
+                Next = Parent->FindNext(Current);
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) { return Left.Current == Right.Current; }
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.AtEnd(); }
+
+        private:
+            constexpr bool AtEnd() const { return Current == std::ranges::end(Parent->Base); }
+
+            ChunkByView* Parent = nullptr;
+            std::ranges::iterator_t<V> Current{};
+            std::ranges::iterator_t<V> Next{};
+        };
+
+    public:
+        ChunkByView() = default;
+        constexpr ChunkByView(V Base, F Pred) : Base(std::move(Base)), Pred(std::move(Pred)) {}
+
+        constexpr auto begin() { return Iterator{this, std::ranges::begin(Base)}; }
+        constexpr auto end() { return std::default_sentinel; }
+
+    private:
+        constexpr auto FindNext(std::ranges::iterator_t<V> Current)
+        {
+            auto NotPred = [this](auto&& Left, auto&& Right){ return !std::invoke(*Pred, Left, Right); };
+            return std::ranges::next(std::ranges::adjacent_find(Current, std::ranges::end(Base), NotPred), 1, std::ranges::end(Base));
+        }
+
+        V Base{};
+        Box<F> Pred{};
+    };
+
+    template<typename R, typename F>
+    ChunkByView(R&&, F) -> ChunkByView<std::views::all_t<R>, F>;
+
+    /// Yields every window of 'Count' consecutive elements, sliding one element at a time (C++20 stand-in for std::views::slide).
+    template<std::ranges::forward_range V>
+        requires std::ranges::view<V>
+    class SlideView : public std::ranges::view_interface<SlideView<V>>
+    {
+        using DifferenceType = std::ranges::range_difference_t<V>;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = std::ranges::subrange<std::ranges::iterator_t<V>>;
+            using difference_type = DifferenceType;
+
+            Iterator() = default;
+            constexpr Iterator(std::ranges::iterator_t<V> Current, std::ranges::sentinel_t<V> End, DifferenceType Count)
+                : Current(Current), Last(std::ranges::next(Current, Count - 1, End)), End(End) {}
+
+            constexpr value_type operator*() const { return {Current, std::ranges::next(Last)}; }
+
+            constexpr Iterator& operator++()
+            {
+                ++Current;
+                ++Last;
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) { return Left.Last == Right.Last; }
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Last == It.End; }
+
+        private:
+            std::ranges::iterator_t<V> Current{};
+            std::ranges::iterator_t<V> Last{};
+            std::ranges::sentinel_t<V> End{};
+        };
+
+    public:
+        SlideView() = default;
+        constexpr SlideView(V Base, DifferenceType Count) : Base(std::move(Base)), Count(Count) {}
+
+        constexpr auto begin() { return Iterator{std::ranges::begin(Base), std::ranges::end(Base), Count}; }
+        constexpr auto end() { return std::default_sentinel; }
+
+        constexpr auto size() requires std::ranges::sized_range<V>
+        {
+            auto Size = static_cast<DifferenceType>(std::ranges::size(Base)) - Count + 1;
+            return static_cast<std::size_t>(std::max<DifferenceType>(Size, 0));
+        }
+
+    private:
+        V Base{};
+        DifferenceType Count = 0;
+    };
+
+    template<typename R, typename N>
+    SlideView(R&&, N) -> SlideView<std::views::all_t<R>>;
+
+    /// Yields the running result of folding each element into the accumulator (an inclusive prefix reduction).
+    template<std::ranges::input_range V, typename Acc, typename F>
+        requires std::ranges::view<V>
+    class ScanView : public std::ranges::view_interface<ScanView<V, Acc, F>>
+    {
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::conditional_t<std::ranges::forward_range<V>, std::forward_iterator_tag, std::input_iterator_tag>;
+            using value_type = Acc;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr Iterator(ScanView* Parent, std::ranges::iterator_t<V> Current) : Parent(Parent), Current(std::move(Current))
+            {
+                if (!AtEnd())
+                    Value.emplace(std::invoke(*Parent->Func, Parent->InitialValue, *this->Current));
+            }
+
+            constexpr Acc operator*() const { return *Value; }
+
+            constexpr Iterator& operator++()
+            {
+                if (!AtEnd() && ++Current != std::ranges::end(Parent->Base))
+                    Value.emplace(std::invoke(*Parent->Func, std::move(*Value), *Current));
+
+                return *this;
+            }
+
+            constexpr void operator++(int) requires (!std::ranges::forward_range<V>) { ++*this; }
+
+            constexpr Iterator operator++(int) requires std::ranges::forward_range<V>
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right)
+                requires std::ranges::forward_range<V>
+            {
+                return Left.Current == Right.Current;
+            }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.AtEnd(); }
+
+        private:
+            constexpr bool AtEnd() const { return Current == std::ranges::end(Parent->Base); }
+
+            ScanView* Parent = nullptr;
+            std::ranges::iterator_t<V> Current{};
+            std::optional<Acc> Value{};
+        };
+
+    public:
+        ScanView() = default;
+        constexpr ScanView(V Base, Acc InitialValue, F Func) : Base(std::move(Base)), InitialValue(std::move(InitialValue)), Func(std::move(Func)) {}
+
+        constexpr auto begin() { return Iterator{this, std::ranges::begin(Base)}; }
+        constexpr auto end() { return std::default_sentinel; }
+
+        constexpr auto size() requires std::ranges::sized_range<V> { return std::ranges::size(Base); }
+
+    private:
+        V Base{};
+        Acc InitialValue{};
+        Box<F> Func{};
+    };
+
+    template<typename R, typename Acc, typename F>
+    ScanView(R&&, Acc, F) -> ScanView<std::views::all_t<R>, Acc, F>;
+
+    /// Sliding reduction in O(1) amortized per element for any associative Func, without an inverse: new elements
+    /// go on the back stack with a running aggregate, and when the front stack runs dry the back stack is flipped
+    /// into suffix aggregates (the two-stack queue).
+    template<typename T, typename F>
+    class TwoStackQueue
+    {
+    public:
+        constexpr explicit TwoStackQueue(F Func) : Func(std::move(Func)) {}
+
+        constexpr std::size_t Size() const { return Front.size() + Back.size(); }
+
+        constexpr void Push(T Value)
+        {
+            BackAggregate = BackAggregate ? std::invoke(Func, std::move(*BackAggregate), Value) : Value;
+            Back.push_back(std::move(Value));
+        }
+
+        constexpr void Pop()
+        {
+            if (Front.empty())
+            {
+                for (auto It = Back.rbegin(); It != Back.rend(); ++It)
+                    Front.push_back(Front.empty() ? std::move(*It) : std::invoke(Func, std::move(*It), Front.back()));
+
+                Back.clear();
+                BackAggregate.reset();
+            }
+            Front.pop_back();
+        }
+
+        /// Returns Func folded over the queued elements, oldest first; the queue must not be empty.
+        constexpr T Aggregate() const
+        {
+            if (Front.empty())
+                return *BackAggregate;
+
+            return BackAggregate ? std::invoke(Func, Front.back(), *BackAggregate) : Front.back();
+        }
+
+    private:
+        F Func;
+        std::vector<T> Front{};
+        std::vector<T> Back{};
+        std::optional<T> BackAggregate{};
+    };
+
+    /// Window state emitting the fold of every 'Count' consecutive elements, and of the remainder at the end.
+    template<typename Acc, typename F>
+    struct TumblingCount
+    {
+        std::size_t Count;
+        Acc InitialValue;
+        F Func;
+        std::optional<Acc> Value{};
+        std::size_t Filled = 0;
+
+        template<typename E>
+        constexpr std::optional<Acc> Feed(E&& Element)
+        {
+            Value.emplace(std::invoke(Func, Value ? std::move(*Value) : InitialValue, std::forward<E>(Element)));
+            if (++Filled < Count)
+                return {};
+
+            Filled = 0;
+            return std::exchange(Value, std::nullopt);
+        }
+
+        constexpr std::optional<Acc> Finish() { return std::exchange(Value, std::nullopt); }
+    };
+
+    /// Window state emitting the aggregate of the last 'Count' elements once that many have arrived.
+    template<typename T, typename F>
+    struct SlidingCount
+    {
+        std::size_t Count;
+        TwoStackQueue<T, F> Queue;
+
+        template<typename E>
+        constexpr std::optional<T> Feed(E&& Element)
+        {
+            Queue.Push(std::forward<E>(Element));
+            if (Queue.Size() > Count)
+                Queue.Pop();
+
+            return Queue.Size() == Count ? std::optional<T>{Queue.Aggregate()} : std::nullopt;
+        }
+
+        constexpr std::optional<T> Finish() { return {}; }
+    };
+
+    /// Window state folding elements into windows of 'Width' by the time TimeFunc reads from them, aligned to the
+    /// first element's time; a window is emitted when the first element past it arrives, and the last at the end.
+    /// Times must not decrease, and windows no element falls into are skipped.
+    template<typename Acc, typename F, typename K, typename W, typename Time>
+    struct TumblingTime
+    {
+        K TimeFunc;
+        W Width;
+        Acc InitialValue;
+        F Func;
+        std::optional<Acc> Value{};
+        std::optional<Time> Start{};
+
+        template<typename E>
+        constexpr std::optional<Acc> Feed(E&& Element)
+        {
+            auto Now = std::invoke(TimeFunc, std::as_const(Element));
+            auto Result = std::optional<Acc>{};
+
+            if (!Start)
+            {
+                Start = Now;
+            }
+            else if (Now >= *Start + Width)
+            {
+                // Whole widths only: integer and integral chrono division truncates, floating-point has to be floored
+                auto Widths = (Now - *Start) / Width;
+                if constexpr (std::floating_point<decltype(Widths)>)
+                    Widths = std::floor(Widths);
+
+                *Start += Widths * Width;
+                Result = std::exchange(Value, std::nullopt);
+            }
+
+            Value.emplace(std::invoke(Func, Value ? std::move(*Value) : InitialValue, std::forward<E>(Element)));
+            return Result;
+        }
+
+        constexpr std::optional<Acc> Finish() { return std::exchange(Value, std::nullopt); }
+    };
+
+    /// Window state emitting, for each element, the aggregate of the elements less than 'Width' older than it by the
+    /// time TimeFunc reads from them. Times must not decrease.
+    template<typename T, typename F, typename K, typename W>
+    struct SlidingTime
+    {
+        K TimeFunc;
+        W Width;
+        TwoStackQueue<T, F> Queue;
+        std::deque<std::remove_cvref_t<std::invoke_result_t<K&, const T&>>> Times{};
+
+        template<typename E>
+        constexpr std::optional<T> Feed(E&& Element)
+        {
+            auto Time = std::invoke(TimeFunc, std::as_const(Element));
+            while (!Times.empty() && Times.front() + Width <= Time)
+            {
+                Times.pop_front();
+                Queue.Pop();
+            }
+
+            Times.push_back(Time);
+            Queue.Push(std::forward<E>(Element));
+            return Queue.Aggregate();
+        }
+
+        constexpr std::optional<T> Finish() { return {}; }
+    };
+
+    /// Runs a window state over the view and yields each aggregate it completes. The state is called as
+    /// State.Feed(Element) and, once the view ends, State.Finish(), both returning std::optional<Out>. Elements are
+    /// only pulled up to the next aggregate, so unbounded views work.
+    template<std::ranges::input_range V, typename State>
+        requires std::ranges::view<V>
+    class WindowView : public std::ranges::view_interface<WindowView<V, State>>
+    {
+        using Out = typename decltype(std::declval<State&>().Finish())::value_type;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = Out;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr Iterator(WindowView* Parent, std::ranges::iterator_t<V> Current) : Parent(Parent), Current(std::move(Current)) { Satisfy(); }
+
+            constexpr const Out& operator*() const { return *Value; }
+
+            constexpr Iterator& operator++()
+            {
+                Satisfy();
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return !It.Value; }
+
+        private:
+            // Feeds elements until the state completes an aggregate, flushing it once the view is exhausted
+            constexpr void Satisfy()
+            {
+                Value.reset();
+                for (; Current != std::ranges::end(Parent->Base); ++Current)
+                {
+                    Value = (*Parent->Window).Feed(*Current);
+                    if (Value)
+                    {
+                        ++Current;
+                        return;
+                    }
+                }
+
+                if (!Finished)
+                {
+                    Finished = true;
+                    Value = (*Parent->Window).Finish();
+                }
+            }
+
+            WindowView* Parent = nullptr;
+            std::ranges::iterator_t<V> Current{};
+            std::optional<Out> Value{};
+            bool Finished = false;
+        };
+
+    public:
+        WindowView() = default;
+        constexpr WindowView(V Base, State Initial) : Base(std::move(Base)), Initial(std::move(Initial)) {}
+
+        /// Starts a new pass from a fresh copy of the initial state.
+        constexpr auto begin()
+        {
+            Window = Initial;
+            return Iterator{this, std::ranges::begin(Base)};
+        }
+
+        constexpr auto end() { return std::default_sentinel; }
+
+    private:
+        V Base{};
+        Box<State> Initial{};
+        Box<State> Window{};
+    };
+
+    template<typename R, typename State>
+    WindowView(R&&, State) -> WindowView<std::views::all_t<R>, State>;
+
+    /// Passes a value to a push sink, treating sinks that return void as always wanting more.
+    template<typename S, typename V>
+    constexpr bool Emit(S& Sink, V&& Value)
+    {
+        if constexpr (std::is_void_v<decltype(Sink(std::forward<V>(Value)))>)
+        {
+            Sink(std::forward<V>(Value));
+            return true;
+        }
+        else
+        {
+            return static_cast<bool>(Sink(std::forward<V>(Value)));
+        }
+    }
+
+    /// The empty stage chain of a fused view: forwards each element unchanged.
+    struct IdentityStage
+    {
+        template<typename V, typename S>
+        constexpr bool operator()(V&& Value, S& Sink) const { return Emit(Sink, std::forward<V>(Value)); }
+    };
+
+    /// Runs a chain of Map/Filter stages as one composed function per element instead of nested adaptors.
+    /// Terminals push every upstream element through the chain in a single loop; iterating it still works, one
+    /// output at a time. 'Chain' is called as Chain(Element, Sink) and returns false once the sink wants no more.
+    template<std::ranges::input_range V, typename Chain, typename Out>
+        requires std::ranges::view<V>
+    class FusedView : public std::ranges::view_interface<FusedView<V, Chain, Out>>
+    {
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = Out;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr Iterator(FusedView* Parent, std::ranges::iterator_t<V> Current) : Parent(Parent), Current(std::move(Current)) { Satisfy(); }
+
+            constexpr const Out& operator*() const { return *Value; }
+
+            constexpr Iterator& operator++()
+            {
+                ++Current;
+                Satisfy();
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return !It.Value; }
+
+        private:
+            // Advances to the next upstream element the chain emits a value for
+            constexpr void Satisfy()
+            {
+                Value.reset();
+                auto Capture = [this](auto&& Result)
+                {
+                    Value.emplace(std::forward<decltype(Result)>(Result));
+                    return true;
+                };
+
+                for (; Current != std::ranges::end(Parent->Base); ++Current)
+                {
+                    (*Parent->Stages)(*Current, Capture);
+                    if (Value)
+                        return;
+                }
+            }
+
+            FusedView* Parent = nullptr;
+            std::ranges::iterator_t<V> Current{};
+            std::optional<Out> Value{};
+        };
+
+    public:
+        FusedView() = default;
+        constexpr explicit FusedView(V Base, Chain Stages = {}) : Base(std::move(Base)), Stages(std::move(Stages)) {}
+
+        constexpr auto begin() { return Iterator{this, std::ranges::begin(Base)}; }
+        constexpr auto end() { return std::default_sentinel; }
+
+        /// Pushes every element through the chain into Sink, stopping early once Sink returns false.
+        template<typename S>
+        constexpr void Push(S&& Sink)
+        {
+            for (auto&& Value : Base)
+            {
+                if (!(*Stages)(std::forward<decltype(Value)>(Value), Sink))
+                    return;
+            }
+        }
+
+        /// Appends a transform to the chain.
+        template<typename F>
+        constexpr auto Map(F Func) &&
+        {
+            using NewOut = std::remove_cvref_t<std::invoke_result_t<F&, Out>>;
+
+            auto NewChain = [Previous = std::move(*Stages), Func = std::move(Func)](auto&& Value, auto& Sink) mutable
+            {
+                auto Next = [&](auto&& Result){ return Emit(Sink, std::invoke(Func, std::forward<decltype(Result)>(Result))); };
+                return Previous(std::forward<decltype(Value)>(Value), Next);
+            };
+            return FusedView<V, decltype(NewChain), NewOut>{std::move(Base), std::move(NewChain)};
+        }
+
+        /// Appends a predicate to the chain; elements it rejects stop there.
+        template<typename F>
+        constexpr auto Filter(F Func) &&
+        {
+            auto NewChain = [Previous = std::move(*Stages), Func = std::move(Func)](auto&& Value, auto& Sink) mutable
+            {
+                auto Next = [&](auto&& Result){ return std::invoke(Func, std::as_const(Result)) ? Emit(Sink, std::forward<decltype(Result)>(Result)) : true; };
+                return Previous(std::forward<decltype(Value)>(Value), Next);
+            };
+            return FusedView<V, decltype(NewChain), Out>{std::move(Base), std::move(NewChain)};
+        }
+
+    private:
+        V Base{};
+        Box<Chain> Stages{};
+    };
+
+    template<typename R>
+    FusedView(R&&) -> FusedView<std::views::all_t<R>, IdentityStage, std::ranges::range_value_t<std::views::all_t<R>>>;
+
+    template<typename V>
+    inline constexpr bool IsFused = false;
+
+    template<typename V, typename Chain, typename Out>
+    inline constexpr bool IsFused<FusedView<V, Chain, Out>> = true;
+
+    /// Views produced by Fuse(), whose Map/Filter stages extend the chain and whose terminals push.
+    template<typename V>
+    concept Fused = IsFused<V>;
+
+    /// Filters a contiguous view a block at a time: the predicate runs over the whole block and its results are
+    /// compacted branch-free into a selection vector holding the indices that passed, so the cost per element
+    /// doesn't depend on selectivity. 'Select' is called as Select(Block, Selection) and returns the count it wrote.
+    template<std::ranges::contiguous_range V, typename Select>
+        requires std::ranges::view<V> && std::ranges::sized_range<V>
+    class SelectionView : public std::ranges::view_interface<SelectionView<V, Select>>
+    {
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ranges::range_difference_t<V>;
+
+            Iterator() = default;
+            constexpr explicit Iterator(SelectionView* Parent) : Parent(Parent) { Satisfy(); }
+
+            constexpr decltype(auto) operator*() const { return std::ranges::data(Parent->Base)[Offset + Parent->Selection[Position]]; }
+
+            constexpr Iterator& operator++()
+            {
+                ++Position;
+                Satisfy();
+                return *this;
+            }
+
+            constexpr void operator++(int) { ++*this; }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Position == It.Count; }
+
+        private:
+            // Selects blocks until one keeps at least one element, or the base runs out
+            constexpr void Satisfy()
+            {
+                auto Size = std::ranges::size(Parent->Base);
+                while (Position == Count && Next < Size)
+                {
+                    Offset = Next;
+                    Next = Offset + std::min(Parent->BlockSize, Size - Offset);
+                    Count = Parent->SelectBlock(Offset, Next - Offset);
+                    Position = 0;
+                }
+            }
+
+            SelectionView* Parent = nullptr;
+            std::size_t Offset = 0;
+            std::size_t Next = 0;
+            std::size_t Position = 0;
+            std::size_t Count = 0;
+        };
+
+    public:
+        SelectionView() = default;
+        constexpr SelectionView(V Base, Select Selector, std::size_t BlockSize)
+            : Base(std::move(Base)), Selector(std::move(Selector)), BlockSize(std::max<std::size_t>(BlockSize, 1)) {}
+
+        constexpr auto begin()
+        {
+            Selection.resize(std::min(BlockSize, std::ranges::size(Base)));
+            return Iterator{this};
+        }
+
+        constexpr auto end() { return std::default_sentinel; }
+
+        /// Calls Func(Block, Selection) for each block that keeps at least one element, stopping once Func returns false.
+        template<typename F>
+        constexpr void ForEachBlock(F&& Func)
+        {
+            auto Size = std::ranges::size(Base);
+            Selection.resize(std::min(BlockSize, Size));
+
+            for (std::size_t Offset = 0; Offset < Size; Offset += BlockSize)
+            {
+                auto Length = std::min(BlockSize, Size - Offset);
+                auto Count = SelectBlock(Offset, Length);
+                if (Count && !Func(std::span{std::ranges::data(Base) + Offset, Length}, std::span<const std::uint32_t>{Selection.data(), Count}))
+                    return;
+            }
+        }
+
+        /// Pushes every selected element into Sink, stopping early once Sink returns false.
+        template<typename S>
+        constexpr void Push(S&& Sink)
+        {
+            ForEachBlock([&Sink](auto Block, auto Indices)
+            {
+                for (auto Index : Indices)
+                {
+                    if (!Emit(Sink, Block[Index]))
+                        return false;
+                }
+                return true;
+            });
+        }
+
+        /// Narrows the selection with another predicate, evaluated only on the indices that are still selected.
+        template<typename F>
+        constexpr auto Refine(F Func) &&
+        {
+            auto NewSelect = [Previous = std::move(*Selector), Func = std::move(Func)](auto Block, std::uint32_t* Indices) mutable
+            {
+                auto Count = Previous(Block, Indices);
+                auto Kept = std::size_t{0};
+                for (std::size_t I = 0; I < Count; ++I)
+                {
+                    Indices[Kept] = Indices[I];
+                    Kept += static_cast<bool>(std::invoke(Func, std::as_const(Block[Indices[I]])));
+                }
+                return Kept;
+            };
+            return SelectionView<V, decltype(NewSelect)>{std::move(Base), std::move(NewSelect), BlockSize};
+        }
+
+    private:
+        constexpr std::size_t SelectBlock(std::size_t Offset, std::size_t Length)
+        {
+            return (*Selector)(std::span{std::ranges::data(Base) + Offset, Length}, Selection.data());
+        }
+
+        V Base{};
+        Box<Select> Selector{};
+        std::size_t BlockSize = 1024;
+        std::vector<std::uint32_t> Selection{};
+    };
+
+    /// Builds a SelectionView whose first predicate writes every index and advances only past those that pass.
+    template<typename V, typename F>
+    constexpr auto SelectBlocks(V Base, F Func, std::size_t BlockSize)
+    {
+        auto Select = [Func = std::move(Func)](auto Block, std::uint32_t* Indices) mutable
+        {
+            auto Kept = std::size_t{0};
+            for (std::size_t I = 0; I < Block.size(); ++I)
+            {
+                Indices[Kept] = static_cast<std::uint32_t>(I);
+                Kept += static_cast<bool>(std::invoke(Func, std::as_const(Block[I])));
+            }
+            return Kept;
+        };
+        return SelectionView<V, decltype(Select)>{std::move(Base), std::move(Select), BlockSize};
+    }
+
+    template<typename V>
+    inline constexpr bool IsSelection = false;
+
+    template<typename V, typename Select>
+    inline constexpr bool IsSelection<SelectionView<V, Select>> = true;
+
+    /// Calls Sink.Flush() when the sink buffers values, so ForEach can drain it once the stream is exhausted.
+    template<typename S>
+    constexpr void Flush(S& Sink)
+    {
+        if constexpr (requires { Sink.Flush(); })
+            Sink.Flush();
+    }
+
+    /// Counts the values pushed into it.
+    struct CounterSink
+    {
+        std::size_t Count = 0;
+
+        constexpr void operator()(const auto&) { ++Count; }
+    };
+
+    /// Writes each value through an output iterator (e.g. std::back_inserter or std::ostream_iterator).
+    template<typename It>
+    struct OutputSink
+    {
+        It Out;
+
+        constexpr void operator()(auto&& Value) { *Out++ = std::forward<decltype(Value)>(Value); }
+    };
+
+    /// Buffers values and hands them to a callback as a std::span<const T> every 'Size' values, then once more on flush.
+    template<typename T, typename F>
+    struct BatchSink
+    {
+        std::size_t Size;
+        F Func;
+        std::vector<T> Buffer{};
+
+        BatchSink(std::size_t Size, F Func) : Size(std::max<std::size_t>(Size, 1)), Func(std::move(Func)) { Buffer.reserve(this->Size); }
+
+        void operator()(auto&& Value)
+        {
+            Buffer.push_back(std::forward<decltype(Value)>(Value));
+            if (Buffer.size() == Size)
+                Flush();
+        }
+
+        void Flush()
+        {
+            if (Buffer.empty())
+                return;
+
+            std::invoke(Func, std::span<const T>(Buffer));
+            Buffer.clear();
+        }
+    };
+
+    /// Pushes each value into every sink in turn; a sink that returns false stops receiving values,
+    /// and the tee stops the stream once all of them have.
+    template<typename... S>
+    struct TeeSink
+    {
+        std::tuple<S...> Sinks;
+        std::array<bool, sizeof...(S)> Done{};
+
+        constexpr bool operator()(const auto& Value)
+        {
+            return [&]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                ((Done[I] = Done[I] || !Emit(std::get<I>(Sinks), Value)), ...);
+                return !(Done[I] && ...);
+            }(std::index_sequence_for<S...>{});
+        }
+
+        constexpr void Flush()
+        {
+            std::apply([](auto&... Sink){ (Stream::Detail::Flush(Sink), ...); }, Sinks);
+        }
+    };
+
+    /// Zips contiguous columns of equal length (a structure of arrays) into rows of references, so stages only load
+    /// the columns they read. Random access and sized, so parallel terminals can split it.
+    /// Rows are tuples of references and their value type a tuple of values, so collecting or sorting rows copies them.
+    template<typename... T>
+    class ColumnsView : public std::ranges::view_interface<ColumnsView<T...>>
+    {
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using value_type = std::tuple<std::remove_cv_t<T>...>;
+            using reference = TupleRef<T&...>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            constexpr Iterator(std::tuple<T*...> Columns, difference_type Index) : Columns(Columns), Index(Index) {}
+
+            constexpr reference operator*() const { return (*this)[0]; }
+
+            constexpr reference operator[](difference_type Offset) const
+            {
+                return std::apply([this, Offset](auto*... Column){ return reference(Column[Index + Offset]...); }, Columns);
+            }
+
+            constexpr Iterator& operator++() { ++Index; return *this; }
+            constexpr Iterator operator++(int) { auto Previous = *this; ++Index; return Previous; }
+            constexpr Iterator& operator--() { --Index; return *this; }
+            constexpr Iterator operator--(int) { auto Previous = *this; --Index; return Previous; }
+            constexpr Iterator& operator+=(difference_type Offset) { Index += Offset; return *this; }
+            constexpr Iterator& operator-=(difference_type Offset) { Index -= Offset; return *this; }
+
+            friend constexpr Iterator operator+(Iterator It, difference_type Offset) { return It += Offset; }
+            friend constexpr Iterator operator+(difference_type Offset, Iterator It) { return It += Offset; }
+            friend constexpr Iterator operator-(Iterator It, difference_type Offset) { return It -= Offset; }
+            friend constexpr difference_type operator-(const Iterator& Left, const Iterator& Right) { return Left.Index - Right.Index; }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right) { return Left.Index == Right.Index; }
+            friend constexpr auto operator<=>(const Iterator& Left, const Iterator& Right) { return Left.Index <=> Right.Index; }
+
+        private:
+            std::tuple<T*...> Columns{};
+            difference_type Index = 0;
+        };
+
+        ColumnsView() = default;
+        constexpr explicit ColumnsView(std::span<T>... Columns) : Columns(Columns...) {}
+
+        constexpr auto begin() const { return Iterator{Pointers(), 0}; }
+        constexpr auto end() const { return Iterator{Pointers(), static_cast<std::ptrdiff_t>(size())}; }
+
+        constexpr std::size_t size() const { return std::get<0>(Columns).size(); }
+
+        /// Returns the column at the given position.
+        template<std::size_t I>
+        constexpr auto Column() const { return std::get<I>(Columns); }
+
+    private:
+        constexpr std::tuple<T*...> Pointers() const
+        {
+            return std::apply([](auto... Column){ return std::tuple<T*...>(Column.data()...); }, Columns);
+        }
+
+        std::tuple<std::span<T>...> Columns{};
+    };
+
+    template<typename... T>
+    ColumnsView(std::span<T>...) -> ColumnsView<T...>;
+
+    template<typename V>
+    inline constexpr bool IsColumns = false;
+
+    template<typename... T>
+    inline constexpr bool IsColumns<ColumnsView<T...>> = true;
+
+    /// The virtual interface behind AnyView: elements are pulled a batch at a time, so the dispatch is once per batch.
+    template<typename T>
+    class AnySource
+    {
+    public:
+        virtual ~AnySource() = default;
+
+        /// Starts a new pass over the wrapped view.
+        virtual void Begin() = 0;
+
+        /// Moves up to Out.size() elements into Out and returns how many it wrote, 0 once the pass is over.
+        virtual std::size_t Pull(std::span<T> Out) = 0;
+
+        /// Move-constructs the source into Buffer, which is large and aligned enough to hold it.
+        virtual AnySource* MoveTo(void* Buffer) noexcept = 0;
+    };
+
+    template<typename T, typename V>
+    class AnySourceFor final : public AnySource<T>
+    {
+    public:
+        explicit AnySourceFor(V Base) : Base(std::move(Base)) {}
+
+        void Begin() override { Current.emplace(std::ranges::begin(Base)); }
+
+        std::size_t Pull(std::span<T> Out) override
+        {
+            // A local iterator keeps the stores into Out from forcing it back to memory on every element
+            auto It = std::move(*Current);
+            auto Count = std::size_t{0};
+            for (auto End = std::ranges::end(Base); Count < Out.size() && It != End; ++It)
+                Out[Count++] = static_cast<T>(*It);
+
+            Current.emplace(std::move(It));
+            return Count;
+        }
+
+        AnySource<T>* MoveTo(void* Buffer) noexcept override { return ::new (Buffer) AnySourceFor(std::move(*this)); }
+
+    private:
+        V Base;
+        std::optional<std::ranges::iterator_t<V>> Current{};
+    };
+
+    /// Type-erased input view of T over any view whose elements convert to T, so a pipeline can be stored, returned
+    /// across translation units or rebuilt at runtime under one type. Iteration pulls batches of elements through a
+    /// single virtual call into an inline buffer, and wrapped views of up to 'InlineSize' bytes are stored inline
+    /// rather than on the heap. Move-only; moving it invalidates its iterators.
+    template<typename T>
+        requires std::default_initializable<T> && std::movable<T>
+    class AnyView : public std::ranges::view_interface<AnyView<T>>
+    {
+    public:
+        /// Bytes available to store the wrapped view (with its vtable pointer) without a heap allocation.
+        static constexpr std::size_t InlineSize = 64;
+
+        /// Elements pulled per virtual call.
+        static constexpr std::size_t BatchSize = std::max<std::size_t>(1, 1024 / sizeof(T));
+
+    private:
+        template<typename V>
+        static constexpr bool StoredInline = sizeof(AnySourceFor<T, V>) <= InlineSize && alignof(AnySourceFor<T, V>) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<V>;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(AnyView* Parent) : Parent(Parent) {}
+
+            T& operator*() const { return Parent->Batch[Parent->Position]; }
+
+            Iterator& operator++()
+            {
+                if (++Parent->Position == Parent->Filled)
+                    Parent->Refill();
+
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.AtEnd(); }
+
+        private:
+            bool AtEnd() const { return Parent->Position == Parent->Filled; }
+
+            AnyView* Parent = nullptr;
+        };
+
+    public:
+        AnyView() = default;
+
+        template<std::ranges::input_range V>
+            requires std::ranges::view<V> && (!std::same_as<V, AnyView>) && std::convertible_to<std::ranges::range_reference_t<V>, T>
+        explicit AnyView(V Base)
+        {
+            if constexpr (StoredInline<V>)
+                Source = ::new (static_cast<void*>(Storage)) AnySourceFor<T, V>(std::move(Base));
+            else
+                Source = new AnySourceFor<T, V>(std::move(Base));
+        }
+
+        AnyView(AnyView&& Other) noexcept { Take(std::move(Other)); }
+
+        AnyView& operator=(AnyView&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Reset();
+                Take(std::move(Other));
+            }
+            return *this;
+        }
+
+        ~AnyView() { Reset(); }
+
+        /// Checks if the wrapped view lives in the inline buffer rather than on the heap.
+        bool IsInline() const { return Source && static_cast<const void*>(Source) == static_cast<const void*>(Storage); }
+
+        auto begin()
+        {
+            Position = Filled = 0;
+            if (Source)
+            {
+                Source->Begin();
+                Refill();
+            }
+            return Iterator{this};
+        }
+
+        auto end() { return std::default_sentinel; }
+
+        /// Pushes every element into Sink a batch at a time, stopping early once Sink returns false.
+        template<typename S>
+        void Push(S&& Sink)
+        {
+            if (!Source)
+                return;
+
+            Source->Begin();
+            for (auto Count = Source->Pull(Batch); Count; Count = Source->Pull(Batch))
+            {
+                for (std::size_t Index = 0; Index < Count; ++Index)
+                {
+                    if (!Emit(Sink, Batch[Index]))
+                        return;
+                }
+            }
+        }
+
+    private:
+        void Refill()
+        {
+            Position = 0;
+            Filled = Source->Pull(Batch);
+        }
+
+        void Take(AnyView&& Other) noexcept
+        {
+            if (Other.IsInline())
+            {
+                Source = Other.Source->MoveTo(Storage);
+                Other.Reset();
+            }
+            else
+            {
+                Source = std::exchange(Other.Source, nullptr);
+            }
+        }
+
+        void Reset() noexcept
+        {
+            if (IsInline())
+                Source->~AnySource();
+            else
+                delete Source;
+
+            Source = nullptr;
+            Position = Filled = 0;
+        }
+
+        alignas(std::max_align_t) std::byte Storage[InlineSize];
+        AnySource<T>* Source = nullptr;
+        std::array<T, BatchSize> Batch{};
+        std::size_t Position = 0;
+        std::size_t Filled = 0;
+    };
+
+    template<typename V>
+    inline constexpr bool IsErased = false;
+
+    template<typename T>
+    inline constexpr bool IsErased<AnyView<T>> = true;
+
+    /// Views whose terminals drive a Push loop instead of iterating: fused chains, block selections and erased streams.
+    template<typename V>
+    concept Pushable = IsFused<V> || IsSelection<V> || IsErased<V>;
+
+    /// Runs a producer the first time the view is iterated and serves the container it returns from then on.
+    /// Copies share the produced container, so every terminal on the stream reuses one evaluation (not thread-safe).
+    template<typename F>
+    class DeferredView : public std::ranges::view_interface<DeferredView<F>>
+    {
+        using ContainerType = std::invoke_result_t<F&>;
+
+        struct State
+        {
+            Box<F> Producer;
+            std::optional<ContainerType> Result{};
+        };
+
+    public:
+        DeferredView() = default;
+        explicit DeferredView(F Producer) : Shared(std::make_shared<State>(State{Box<F>{std::move(Producer)}})) {}
+
+        auto begin() { return std::ranges::begin(Evaluate()); }
+        auto end() { return std::ranges::end(Evaluate()); }
+
+        auto size() requires std::ranges::sized_range<ContainerType> { return std::ranges::size(Evaluate()); }
+
+    private:
+        ContainerType& Evaluate()
+        {
+            if (!Shared->Result)
+                Shared->Result.emplace(std::invoke(*Shared->Producer));
+
+            return *Shared->Result;
+        }
+
+        std::shared_ptr<State> Shared{};
+    };
+
+    /// Contiguous ranges of single-byte values, which SplitBy can scan with memchr instead of element by element.
+    template<typename V>
+    concept ByteRange = std::ranges::contiguous_range<V> && std::ranges::sized_range<V>
+        && sizeof(std::ranges::range_value_t<V>) == 1 && std::is_trivially_copyable_v<std::ranges::range_value_t<V>>;
+
+    /// Tokens ByteSplitView accepts for a byte range: a single element, or a contiguous run of elements (e.g. a string).
+    template<typename V, typename Token>
+    concept ByteToken = ByteRange<V> && (std::same_as<std::remove_cvref_t<Token>, std::ranges::range_value_t<V>>
+        || (std::same_as<std::ranges::range_value_t<V>, char> && std::convertible_to<const Token&, std::string_view>)
+        || (std::ranges::contiguous_range<Token> && std::same_as<std::ranges::range_value_t<Token>, std::ranges::range_value_t<V>>));
+
+    /// Splits a contiguous byte range on a delimiter, finding each occurrence with memchr (vectorized in common libcs)
+    /// and yielding the pieces as std::string_view for char data and std::span otherwise, with std::views::split semantics.
+    template<ByteRange V>
+        requires std::ranges::view<V>
+    class ByteSplitView : public std::ranges::view_interface<ByteSplitView<V>>
+    {
+        using ValueType = std::ranges::range_value_t<V>;
+        using PieceType = std::conditional_t<std::same_as<ValueType, char>, std::string_view, std::span<const ValueType>>;
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = PieceType;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            constexpr Iterator(const ByteSplitView* Parent, const ValueType* Current, const ValueType* End)
+                : Parent(Parent), Current(Current), Next(Current == End ? End : Parent->Find(Current, End)), End(End) {}
+
+            constexpr PieceType operator*() const { return PieceType(Current, static_cast<std::size_t>(Next - Current)); }
+
+            constexpr Iterator& operator++()
+            {
+                if (Next == End)
+                {
+                    Current = End;
+                    TrailingEmpty = false;
+                    return *this;
+                }
+
+                Current = Next + Parent->Delimiter.size();
+                if (Current == End)
+                {
+                    TrailingEmpty = true;
+                    Next = End;
+                }
+                else
+                {
+                    Next = Parent->Find(Current, End);
+                }
+
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend constexpr bool operator==(const Iterator& Left, const Iterator& Right)
+            {
+                return Left.Current == Right.Current && Left.TrailingEmpty == Right.TrailingEmpty;
+            }
+
+            friend constexpr bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Current == It.End && !It.TrailingEmpty; }
+
+        private:
+            const ByteSplitView* Parent = nullptr;
+            const ValueType* Current = nullptr;
+            const ValueType* Next = nullptr;
+            const ValueType* End = nullptr;
+            bool TrailingEmpty = false;
+        };
+
+    public:
+        ByteSplitView() = default;
+
+        template<typename Token>
+        constexpr ByteSplitView(V Base, const Token& Delimiter) : Base(std::move(Base))
+        {
+            if constexpr (std::same_as<std::remove_cvref_t<Token>, ValueType>)
+            {
+                this->Delimiter.push_back(Delimiter);
+            }
+            else if constexpr (std::convertible_to<const Token&, std::string_view> && std::same_as<ValueType, char>)
+            {
+                auto Text = std::string_view(Delimiter);
+                this->Delimiter.assign(Text.begin(), Text.end());
+            }
+            else
+            {
+                this->Delimiter.assign(std::ranges::begin(Delimiter), std::ranges::end(Delimiter));
+            }
+        }
+
+        constexpr auto begin() const
+        {
+            auto Data = std::to_address(std::ranges::begin(Base));
+            return Iterator{this, Data, Data + std::ranges::size(Base)};
+        }
+
+        constexpr auto end() const { return std::default_sentinel; }
+
+    private:
+        /// Returns the start of the next delimiter in [Current, End), or End.
+        constexpr const ValueType* Find(const ValueType* Current, const ValueType* End) const
+        {
+            if (Delimiter.empty())
+                return Current + 1;
+
+            auto First = std::bit_cast<unsigned char>(Delimiter.front());
+            auto Length = Delimiter.size();
+
+            // memchr and memcmp aren't constexpr, so constant evaluation compares byte by byte
+            if (std::is_constant_evaluated())
+            {
+                auto Same = [](ValueType Left, ValueType Right){ return std::bit_cast<unsigned char>(Left) == std::bit_cast<unsigned char>(Right); };
+                for (; static_cast<std::size_t>(End - Current) >= Length; ++Current)
+                {
+                    if (std::equal(Delimiter.begin(), Delimiter.end(), Current, Same))
+                        return Current;
+                }
+
+                return End;
+            }
+
+            while (static_cast<std::size_t>(End - Current) >= Length)
+            {
+                auto Found = static_cast<const ValueType*>(std::memchr(Current, First, static_cast<std::size_t>(End - Current) - Length + 1));
+                if (!Found)
+                    break;
+
+                if (Length == 1 || std::memcmp(Found + 1, Delimiter.data() + 1, Length - 1) == 0)
+                    return Found;
+
+                Current = Found + 1;
+            }
+
+            return End;
+        }
+
+        V Base{};
+        std::vector<ValueType> Delimiter{};
+    };
+
+    template<typename R, typename Token>
+    ByteSplitView(R&&, const Token&) -> ByteSplitView<std::views::all_t<R>>;
+
+#if STREAM_FILES
+    /// Read-only memory mapping of a whole file, unmapped on destruction.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& Path)
+        {
+#if defined(_WIN32)
+            File = ::CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (File == INVALID_HANDLE_VALUE)
+                throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "Stream::mmap: " + Path.string());
+
+            auto FileSize = LARGE_INTEGER{};
+            ::GetFileSizeEx(File, &FileSize);
+            Length = static_cast<std::size_t>(FileSize.QuadPart);
+
+            if (Length == 0)
+                return;
+
+            Mapping = ::CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            Data = Mapping ? static_cast<const char*>(::MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (!Data)
+            {
+                auto Error = static_cast<int>(::GetLastError());
+                Close();
+                throw std::system_error(Error, std::system_category(), "Stream::mmap: " + Path.string());
+            }
+#else
+            auto Descriptor = ::open(Path.c_str(), O_RDONLY);
+            if (Descriptor < 0)
+                throw std::system_error(errno, std::generic_category(), "Stream::mmap: " + Path.string());
+
+            struct stat Info{};
+            if (::fstat(Descriptor, &Info) != 0)
+            {
+                auto Error = errno;
+                ::close(Descriptor);
+                throw std::system_error(Error, std::generic_category(), "Stream::mmap: " + Path.string());
+            }
+
+            Length = static_cast<std::size_t>(Info.st_size);
+            if (Length != 0)
+            {
+                auto Address = ::mmap(nullptr, Length, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+                if (Address == MAP_FAILED)
+                {
+                    auto Error = errno;
+                    ::close(Descriptor);
+                    throw std::system_error(Error, std::generic_category(), "Stream::mmap: " + Path.string());
+                }
+
+                ::madvise(Address, Length, MADV_SEQUENTIAL);
+                Data = static_cast<const char*>(Address);
+            }
+
+            ::close(Descriptor);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() { Close(); }
+
+        const char* data() const { return Data; }
+        std::size_t size() const { return Length; }
+
+    private:
+        void Close()
+        {
+#if defined(_WIN32)
+            if (Data)
+                ::UnmapViewOfFile(Data);
+            if (Mapping)
+                ::CloseHandle(Mapping);
+            if (File != INVALID_HANDLE_VALUE)
+                ::CloseHandle(File);
+#else
+            if (Data)
+                ::munmap(const_cast<char*>(Data), Length);
+#endif
+        }
+
+#if defined(_WIN32)
+        HANDLE File = INVALID_HANDLE_VALUE;
+        HANDLE Mapping = nullptr;
+#endif
+        const char* Data = nullptr;
+        std::size_t Length = 0;
+    };
+
+    /// Magic at the start of files written by WriteTo, followed by the element size and a byte order mark.
+    inline constexpr char BlockFileMagic[8] = {'S', 'T', 'R', 'M', 'B', 'L', 'K', '1'};
+
+    struct BlockFileHeader
+    {
+        char Magic[8];
+        std::uint32_t ElementSize;
+        std::uint32_t ByteOrder;
+    };
+
+    /// Precedes each block's payload, which is padded to 16 bytes so uncompressed elements are aligned in a mapping.
+    struct BlockHeader
+    {
+        std::uint32_t Count;
+        std::uint32_t StoredBytes;
+        std::uint32_t Codec;
+        std::uint32_t Checksum;
+    };
+
+    inline constexpr std::uint32_t BlockByteOrder = 0x01020304u;
+    inline constexpr std::size_t BlockAlignment = 16;
+
+    /// Checksums a block: four multiply-rotate lanes over 8-byte words, folded to 32 bits.
+    inline std::uint32_t BlockChecksum(const char* Data, std::size_t Size)
+    {
+        constexpr auto Prime = 0x9E3779B185EBCA87ull;
+        auto Lanes = std::array<std::uint64_t, 4>{Size, Prime, ~Size, Prime ^ Size};
+
+        auto Index = std::size_t{0};
+        for (; Index + 32 <= Size; Index += 32)
+        {
+            for (std::size_t Lane = 0; Lane < 4; ++Lane)
+            {
+                auto Word = std::uint64_t{};
+                std::memcpy(&Word, Data + Index + Lane * 8, 8);
+                Lanes[Lane] = std::rotl(Lanes[Lane] ^ Word * Prime, 31) * Prime;
+            }
+        }
+
+        for (; Index < Size; ++Index)
+            Lanes[Index % 4] = std::rotl(Lanes[Index % 4] ^ static_cast<unsigned char>(Data[Index]) * Prime, 31) * Prime;
+
+        auto Hash = std::rotl(Lanes[0], 1) + std::rotl(Lanes[1], 7) + std::rotl(Lanes[2], 12) + std::rotl(Lanes[3], 18);
+        Hash = (Hash ^ (Hash >> 29)) * Prime;
+        return static_cast<std::uint32_t>(Hash ^ (Hash >> 32));
+    }
+
+    /// Writes all of Data to a file descriptor, retrying interrupted and partial writes.
+    inline void WriteAll(int Descriptor, const char* Data, std::size_t Size)
+    {
+        while (Size)
+        {
+#if defined(_WIN32)
+            auto Written = ::_write(Descriptor, Data, static_cast<unsigned>(std::min<std::size_t>(Size, 1u << 30)));
+#else
+            auto Written = ::write(Descriptor, Data, Size);
+#endif
+            if (Written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error(errno, std::generic_category(), "Stream::WriteTo");
+            }
+
+            Data += Written;
+            Size -= static_cast<std::size_t>(Written);
+        }
+    }
+
+    /// Sink writing trivially copyable values to a file descriptor in the block format Stream::read maps back.
+    /// Writes the file header up front and a block every 'BlockSize' bytes of elements, plus the rest on flush;
+    /// block headers store sizes in 32 bits, so larger blocks (or, with LZ4, blocks LZ4 can't take) throw.
+    template<typename T>
+        requires std::is_trivially_copyable_v<T> && (alignof(T) <= BlockAlignment)
+    class BlockSink
+    {
+    public:
+        BlockSink(int Descriptor, Stream::Compression Codec, std::size_t BlockSize)
+            : Descriptor(Descriptor), Codec(Codec), Capacity(std::max<std::size_t>(BlockSize / sizeof(T), 1))
+        {
+#if !STREAM_LZ4
+            if (Codec == Stream::Compression::LZ4)
+                throw std::invalid_argument("Stream::WriteTo: LZ4 needs STREAM_LZ4 defined to 1");
+#else
+            if (Codec == Stream::Compression::LZ4 && Capacity * sizeof(T) > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+                throw std::invalid_argument("Stream::WriteTo: block size exceeds what LZ4 can compress");
+#endif
+            if (Capacity * sizeof(T) > std::numeric_limits<std::uint32_t>::max())
+                throw std::invalid_argument("Stream::WriteTo: block size doesn't fit in 32 bits");
+
+            auto Header = BlockFileHeader{{}, static_cast<std::uint32_t>(sizeof(T)), BlockByteOrder};
+            std::memcpy(Header.Magic, BlockFileMagic, sizeof(Header.Magic));
+            WriteAll(Descriptor, reinterpret_cast<const char*>(&Header), sizeof(Header));
+            Pending.reserve(Capacity);
+        }
+
+        void operator()(const T& Value)
+        {
+            Pending.push_back(Value);
+            if (Pending.size() == Capacity)
+                Flush();
+        }
+
+        /// Writes the buffered elements as a block.
+        void Flush()
+        {
+            if (Pending.empty())
+                return;
+
+            auto Payload = reinterpret_cast<const char*>(Pending.data());
+            auto Header = BlockHeader{static_cast<std::uint32_t>(Pending.size()), static_cast<std::uint32_t>(Pending.size() * sizeof(T)), 0, 0};
+
+#if STREAM_LZ4
+            // Blocks LZ4 can't shrink are stored as they are
+            if (Codec == Stream::Compression::LZ4)
+            {
+                Compressed.resize(static_cast<std::size_t>(::LZ4_compressBound(static_cast<int>(Header.StoredBytes))));
+                auto Size = ::LZ4_compress_default(Payload, Compressed.data(), static_cast<int>(Header.StoredBytes), static_cast<int>(Compressed.size()));
+                if (Size > 0 && static_cast<std::uint32_t>(Size) < Header.StoredBytes)
+                {
+                    Payload = Compressed.data();
+                    Header.StoredBytes = static_cast<std::uint32_t>(Size);
+                    Header.Codec = static_cast<std::uint32_t>(Stream::Compression::LZ4);
+                }
+            }
+#endif
+
+            Header.Checksum = BlockChecksum(Payload, Header.StoredBytes);
+
+            constexpr auto Padding = std::array<char, BlockAlignment>{};
+            WriteAll(Descriptor, reinterpret_cast<const char*>(&Header), sizeof(Header));
+            WriteAll(Descriptor, Payload, Header.StoredBytes);
+            WriteAll(Descriptor, Padding.data(), (BlockAlignment - Header.StoredBytes % BlockAlignment) % BlockAlignment);
+
+            Written += Pending.size();
+            Pending.clear();
+        }
+
+        /// Returns the number of elements written so far.
+        std::size_t Count() const { return Written; }
+
+    private:
+        int Descriptor;
+        Stream::Compression Codec;
+        std::size_t Capacity;
+        std::vector<T> Pending{};
+        std::vector<char> Compressed{};
+        std::size_t Written = 0;
+    };
+
+    /// Closes a file descriptor it owns on destruction.
+    class DescriptorGuard
+    {
+    public:
+        explicit DescriptorGuard(int Descriptor) : Descriptor(Descriptor) {}
+        DescriptorGuard(const DescriptorGuard&) = delete;
+        DescriptorGuard& operator=(const DescriptorGuard&) = delete;
+
+        ~DescriptorGuard()
+        {
+#if defined(_WIN32)
+            ::_close(Descriptor);
+#else
+            ::close(Descriptor);
+#endif
+        }
+
+        int Get() const { return Descriptor; }
+
+    private:
+        int Descriptor;
+    };
+
+    /// Reads a block file written by WriteTo from a memory mapping: uncompressed blocks are served in place, and
+    /// each block's checksum is verified when iteration reaches it. Copies share the mapping and the position.
+    template<typename T>
+        requires std::is_trivially_copyable_v<T> && (alignof(T) <= BlockAlignment)
+    class BlockFileView : public std::ranges::view_interface<BlockFileView<T>>
+    {
+        struct State
+        {
+            std::shared_ptr<const MappedFile> File;
+            std::size_t Offset = 0;
+            std::span<const T> Block{};
+            std::size_t Position = 0;
+            std::vector<T> Buffer{};
+
+            // Moves to the next block holding any elements, or to an empty block at the end of the file
+            void Next()
+            {
+                Block = {};
+                Position = 0;
+
+                while (Block.empty() && Offset < File->size())
+                {
+                    auto Header = BlockHeader{};
+                    if (File->size() - Offset < sizeof(Header))
+                        throw std::runtime_error("Stream::read: truncated block header");
+
+                    std::memcpy(&Header, File->data() + Offset, sizeof(Header));
+                    auto Payload = File->data() + Offset + sizeof(Header);
+                    if (File->size() - Offset - sizeof(Header) < Header.StoredBytes)
+                        throw std::runtime_error("Stream::read: truncated block");
+
+                    if (BlockChecksum(Payload, Header.StoredBytes) != Header.Checksum)
+                        throw std::runtime_error("Stream::read: checksum mismatch in block at offset " + std::to_string(Offset));
+
+                    Offset += sizeof(Header) + (Header.StoredBytes + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+
+                    if (Header.Codec == static_cast<std::uint32_t>(Stream::Compression::None))
+                    {
+                        if (Header.StoredBytes != Header.Count * sizeof(T))
+                            throw std::runtime_error("Stream::read: block size doesn't match its element count");
+
+                        // The mapping is page aligned and payloads are padded to BlockAlignment
+                        Block = {reinterpret_cast<const T*>(Payload), Header.Count};
+                    }
+                    else if (Header.Codec == static_cast<std::uint32_t>(Stream::Compression::LZ4))
+                    {
+#if STREAM_LZ4
+                        Buffer.resize(Header.Count);
+                        auto Size = ::LZ4_decompress_safe(Payload, reinterpret_cast<char*>(Buffer.data()), static_cast<int>(Header.StoredBytes), static_cast<int>(Header.Count * sizeof(T)));
+                        if (Size < 0 || static_cast<std::size_t>(Size) != Header.Count * sizeof(T))
+                            throw std::runtime_error("Stream::read: corrupt LZ4 block");
+
+                        Block = Buffer;
+#else
+                        throw std::runtime_error("Stream::read: LZ4 blocks need STREAM_LZ4 defined to 1");
+#endif
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Stream::read: unknown block codec");
+                    }
+                }
+            }
+        };
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(State* Shared) : Shared(Shared) {}
+
+            const T& operator*() const { return Shared->Block[Shared->Position]; }
+
+            Iterator& operator++()
+            {
+                if (++Shared->Position == Shared->Block.size())
+                    Shared->Next();
+
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Shared->Block.empty(); }
+
+        private:
+            State* Shared = nullptr;
+        };
+
+    public:
+        BlockFileView() = default;
+
+        /// Checks the file header, throwing std::runtime_error when the file isn't a block file of T.
+        explicit BlockFileView(std::shared_ptr<const MappedFile> File) : Shared(std::make_shared<State>(State{std::move(File)}))
+        {
+            auto Header = BlockFileHeader{};
+            if (Shared->File->size() < sizeof(Header))
+                throw std::runtime_error("Stream::read: not a block file");
+
+            std::memcpy(&Header, Shared->File->data(), sizeof(Header));
+            if (std::memcmp(Header.Magic, BlockFileMagic, sizeof(Header.Magic)) != 0 || Header.ByteOrder != BlockByteOrder)
+                throw std::runtime_error("Stream::read: not a block file, or written with another byte order");
+
+            if (Header.ElementSize != sizeof(T))
+                throw std::runtime_error("Stream::read: file holds elements of " + std::to_string(Header.ElementSize) + " bytes");
+        }
+
+        /// Starts a new pass from the first block.
+        auto begin()
+        {
+            Shared->Offset = sizeof(BlockFileHeader);
+            Shared->Next();
+            return Iterator{Shared.get()};
+        }
+
+        auto end() { return std::default_sentinel; }
+
+    private:
+        std::shared_ptr<State> Shared{};
+    };
+
+    /// Contiguous view over a mapped file; copies share the mapping, which stays alive while any copy does.
+    class MappedView : public std::ranges::view_interface<MappedView>
+    {
+    public:
+        MappedView() = default;
+        explicit MappedView(std::shared_ptr<const MappedFile> File) : File(std::move(File)) {}
+
+        const char* begin() const { return File ? File->data() : nullptr; }
+        const char* end() const { return File ? File->data() + File->size() : nullptr; }
+
+        /// Returns the mapped bytes.
+        std::span<const char> Span() const { return {begin(), end()}; }
+
+    private:
+        std::shared_ptr<const MappedFile> File{};
+    };
+
+    /// Yields each line of a mapped file as a std::string_view into the mapping, without the line terminator.
+    class LinesView : public std::ranges::view_interface<LinesView>
+    {
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const char* Current, const char* End) : Current(Current), End(End) { FindLineEnd(); }
+
+            std::string_view operator*() const
+            {
+                auto Length = static_cast<std::size_t>(LineEnd - Current);
+                if (Length && Current[Length - 1] == '\r')
+                    --Length;
+
+                return {Current, Length};
+            }
+
+            Iterator& operator++()
+            {
+                Current = LineEnd == End ? End : LineEnd + 1;
+                FindLineEnd();
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                auto Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            friend bool operator==(const Iterator& Left, const Iterator& Right) { return Left.Current == Right.Current; }
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Current == It.End; }
+
+        private:
+            void FindLineEnd()
+            {
+                auto Found = Current == End ? nullptr : static_cast<const char*>(std::memchr(Current, '\n', static_cast<std::size_t>(End - Current)));
+                LineEnd = Found ? Found : End;
+            }
+
+            const char* Current = nullptr;
+            const char* LineEnd = nullptr;
+            const char* End = nullptr;
+        };
+
+    public:
+        LinesView() = default;
+        explicit LinesView(MappedView Base) : Base(std::move(Base)) {}
+
+        auto begin() const { return Iterator{Base.begin(), Base.end()}; }
+        auto end() const { return std::default_sentinel; }
+
+    private:
+        MappedView Base{};
+    };
+#endif
+
+    /// Yields each line read from a stream; the std::string_view stays valid until the next increment.
+    /// One buffer is reused for every line, so lines only allocate when they are longer than any before them.
+    class StreamLinesView : public std::ranges::view_interface<StreamLinesView>
+    {
+        struct State
+        {
+            std::istream* Input = nullptr;
+            std::string Line{};
+            bool Done = false;
+
+            void Next() { Done = !std::getline(*Input, Line); }
+        };
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(State* Shared) : Shared(Shared) {}
+
+            std::string_view operator*() const
+            {
+                auto Line = std::string_view{Shared->Line};
+                return Line.ends_with('\r') ? Line.substr(0, Line.size() - 1) : Line;
+            }
+
+            Iterator& operator++()
+            {
+                Shared->Next();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Shared->Done; }
+
+        private:
+            State* Shared = nullptr;
+        };
+
+    public:
+        StreamLinesView() = default;
+        explicit StreamLinesView(std::istream& Input) : Shared(std::make_shared<State>(State{&Input})) {}
+
+        auto begin()
+        {
+            Shared->Next();
+            return Iterator{Shared.get()};
+        }
+
+        auto end() { return std::default_sentinel; }
+
+    private:
+        std::shared_ptr<State> Shared{};
+    };
+
+#if STREAM_FILES
+    /// Reads a file descriptor block by block, yielding each block as a std::span that stays valid until the next increment.
+    class BytesView : public std::ranges::view_interface<BytesView>
+    {
+        struct State
+        {
+            int Descriptor = -1;
+            bool Owned = false;
+            std::vector<char> Buffer{};
+            std::size_t Filled = 0;
+
+            State(int Descriptor, bool Owned, std::size_t BlockSize) : Descriptor(Descriptor), Owned(Owned), Buffer(std::max<std::size_t>(BlockSize, 1)) {}
+            State(const State&) = delete;
+            State& operator=(const State&) = delete;
+
+            ~State()
+            {
+                if (Owned)
+                {
+#if defined(_WIN32)
+                    ::_close(Descriptor);
+#else
+                    ::close(Descriptor);
+#endif
+                }
+            }
+
+            void Next()
+            {
+                while (true)
+                {
+#if defined(_WIN32)
+                    auto Read = ::_read(Descriptor, Buffer.data(), static_cast<unsigned>(Buffer.size()));
+#else
+                    auto Read = ::read(Descriptor, Buffer.data(), Buffer.size());
+#endif
+                    if (Read >= 0)
+                    {
+                        Filled = static_cast<std::size_t>(Read);
+                        return;
+                    }
+
+                    if (errno != EINTR)
+                        throw std::system_error(errno, std::generic_category(), "Stream::bytes");
+                }
+            }
+        };
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::span<const char>;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(State* Shared) : Shared(Shared) {}
+
+            std::span<const char> operator*() const { return {Shared->Buffer.data(), Shared->Filled}; }
+
+            Iterator& operator++()
+            {
+                Shared->Next();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Shared->Filled == 0; }
+
+        private:
+            State* Shared = nullptr;
+        };
+
+    public:
+        BytesView() = default;
+        BytesView(int Descriptor, bool Owned, std::size_t BlockSize) : Shared(std::make_shared<State>(Descriptor, Owned, BlockSize)) {}
+
+        auto begin()
+        {
+            Shared->Next();
+            return Iterator{Shared.get()};
+        }
+
+        auto end() { return std::default_sentinel; }
+
+    private:
+        std::shared_ptr<State> Shared{};
+    };
+#endif
+
+    /// Yields the elements consumers pop from a ring, a batch at a time, until its producers have closed it.
+    template<typename T>
+    class RingView : public std::ranges::view_interface<RingView<T>>
+    {
+        struct State
+        {
+            Stream::Ring<T>* Source;
+            std::vector<T> Buffer;
+            std::size_t Index = 0;
+            std::size_t Filled = 0;
+
+            void Next()
+            {
+                Index = 0;
+                Filled = Source->Pop(Buffer);
+            }
+        };
+
+        class Iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(State* Shared) : Shared(Shared) {}
+
+            T& operator*() const { return Shared->Buffer[Shared->Index]; }
+
+            Iterator& operator++()
+            {
+                if (++Shared->Index == Shared->Filled)
+                    Shared->Next();
+
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const Iterator& It, std::default_sentinel_t) { return It.Shared->Filled == 0; }
+
+        private:
+            State* Shared = nullptr;
+        };
+
+    public:
+        RingView() = default;
+        RingView(Stream::Ring<T>& Source, std::size_t BatchSize) : Shared(std::make_shared<State>(State{&Source, std::vector<T>(std::max<std::size_t>(BatchSize, 1))})) {}
+
+        auto begin()
+        {
+            Shared->Next();
+            return Iterator{Shared.get()};
+        }
+
+        auto end() { return std::default_sentinel; }
+
+    private:
+        std::shared_ptr<State> Shared{};
+    };
+}
+
+namespace Stream
+{
+    /// Open addressing hash map with linear probing over an index table kept at most half full, returned by GroupBy
+    /// and Frequencies for hashable keys. It has std::map's lookup members, but entries live densely in insertion
+    /// order, so iterating one walks a plain vector of std::pair<Key, Value>.
+    template<Detail::Hashable Key, typename Value>
+    class FlatMap
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        constexpr explicit FlatMap(std::size_t CapacityHint = 0)
+        {
+            Entries.reserve(CapacityHint);
+            Rehash(std::max<std::size_t>(CapacityHint * 2, 16));
+        }
+
+        /// Returns the value stored for the key, inserting a value-initialized one if it is not present yet.
+        constexpr Value& operator[](const Key& Name)
+        {
+            if ((Entries.size() + 1) * 2 > Slots.size())
+                Rehash(Slots.size() * 2);
+
+            auto Index = Locate(Name);
+            if (!Slots[Index])
+            {
+                Entries.emplace_back(Name, Value{});
+                Slots[Index] = Entries.size();
+            }
+            return Entries[Slots[Index] - 1].second;
+        }
+
+        /// Returns the value stored for the key; throws std::out_of_range if it is not present.
+        constexpr Value& at(const Key& Name) { return const_cast<Value&>(std::as_const(*this).at(Name)); }
+
+        constexpr const Value& at(const Key& Name) const
+        {
+            auto Found = find(Name);
+            if (Found == end())
+                throw std::out_of_range("Stream::FlatMap::at: key not found");
+
+            return Found->second;
+        }
+
+        /// Returns an iterator to the entry holding the key, or end().
+        constexpr iterator find(const Key& Name)
+        {
+            auto Index = Locate(Name);
+            return Slots[Index] ? Entries.begin() + static_cast<std::ptrdiff_t>(Slots[Index] - 1) : Entries.end();
+        }
+
+        constexpr const_iterator find(const Key& Name) const
+        {
+            auto Index = Locate(Name);
+            return Slots[Index] ? Entries.begin() + static_cast<std::ptrdiff_t>(Slots[Index] - 1) : Entries.end();
+        }
+
+        constexpr bool contains(const Key& Name) const { return Slots[Locate(Name)] != 0; }
+        constexpr std::size_t size() const { return Entries.size(); }
+        constexpr bool empty() const { return Entries.empty(); }
+
+        constexpr auto begin() { return Entries.begin(); }
+        constexpr auto end() { return Entries.end(); }
+        constexpr auto begin() const { return Entries.begin(); }
+        constexpr auto end() const { return Entries.end(); }
+
+    private:
+        // Returns the slot holding the key, or the empty slot where it would go
+        constexpr std::size_t Locate(const Key& Name) const
+        {
+            auto Index = static_cast<std::size_t>(Detail::MixHash(std::hash<Key>{}(Name)) >> (64 - Bits));
+            while (Slots[Index] && !(Entries[Slots[Index] - 1].first == Name))
+                Index = (Index + 1) & (Slots.size() - 1);
+
+            return Index;
+        }
+
+        constexpr void Rehash(std::size_t Capacity)
+        {
+            auto NewSize = std::size_t{1};
+            Bits = 0;
+            while (NewSize < Capacity)
+            {
+                NewSize <<= 1;
+                ++Bits;
+            }
+
+            Slots.assign(NewSize, 0);
+            for (auto Entry = std::size_t{0}; Entry < Entries.size(); ++Entry)
+                Slots[Locate(Entries[Entry].first)] = Entry + 1;
+        }
+
+        std::vector<std::pair<Key, Value>> Entries{};
+        std::vector<std::size_t> Slots{};
+        int Bits = 0;
+    };
+
+    namespace Detail
+    {
+        template<typename Key, typename Value>
+        struct GroupMapFor;
+
+        template<typename Key, typename Value> requires Hashable<Key>
+        struct GroupMapFor<Key, Value> { using Type = FlatMap<Key, Value>; };
+
+        template<typename Key, typename Value> requires (!Hashable<Key> && std::totally_ordered<Key>)
+        struct GroupMapFor<Key, Value> { using Type = std::map<Key, Value>; };
+    }
+
+    /// Map returned by GroupBy and Frequencies: a FlatMap for hashable keys and a std::map otherwise, with the same
+    /// size/find/contains/at/operator[] members either way.
+    template<typename Key, typename Value>
+    using GroupMap = typename Detail::GroupMapFor<Key, Value>::Type;
+
+    /// Estimates the number of distinct values in 2^Precision one-byte registers (4 KB by default), with a
+    /// standard error of about 1.04 / sqrt(2^Precision): 1.6% by default. Sketches of parts of a stream merge exactly.
+    template<std::size_t Precision = 12>
+        requires (Precision >= 4 && Precision <= 18)
+    class HyperLogLog
+    {
+    public:
+        /// Adds a value by its std::hash.
+        template<typename V>
+        void Add(const V& Value)
+        {
+            AddHash(static_cast<std::uint64_t>(std::hash<V>{}(Value)));
+        }
+
+        /// Adds a value by its hash, which is mixed again so weak hashes such as the identity for integers work.
+        constexpr void AddHash(std::uint64_t Hash)
+        {
+            Hash = Mix(Hash);
+            auto Index = Hash >> (64 - Precision);
+            auto Rank = static_cast<std::uint8_t>(std::countl_zero((Hash << Precision) | (std::uint64_t{1} << (Precision - 1))) + 1);
+            Registers[Index] = std::max(Registers[Index], Rank);
+        }
+
+        /// Returns an empty sketch of the same precision.
+        constexpr HyperLogLog Empty() const { return {}; }
+
+        /// Combines the sketch of another part of the stream.
+        constexpr void Merge(const HyperLogLog& Other)
+        {
+            for (std::size_t Index = 0; Index < Registers.size(); ++Index)
+                Registers[Index] = std::max(Registers[Index], Other.Registers[Index]);
+        }
+
+        /// Returns the estimated number of distinct values added, counting exactly by linear counting while few are.
+        double Estimate() const
+        {
+            constexpr auto Size = static_cast<double>(std::size_t{1} << Precision);
+
+            auto Inverse = 0.0;
+            auto Zeros = std::size_t{0};
+            for (auto Register : Registers)
+            {
+                Inverse += 1.0 / static_cast<double>(std::uint64_t{1} << Register);
+                Zeros += Register == 0;
+            }
+
+            auto Raw = 0.7213 / (1.0 + 1.079 / Size) * Size * Size / Inverse;
+            if (Raw <= 2.5 * Size && Zeros)
+                return Size * std::log(Size / static_cast<double>(Zeros));
+
+            return Raw;
+        }
+
+    private:
+        // Murmur3's 64-bit finalizer
+        static constexpr std::uint64_t Mix(std::uint64_t Hash)
+        {
+            Hash ^= Hash >> 33;
+            Hash *= 0xFF51AFD7ED558CCDull;
+            Hash ^= Hash >> 33;
+            Hash *= 0xC4CEB9FE1A85EC53ull;
+            return Hash ^ (Hash >> 33);
+        }
+
+        std::array<std::uint8_t, std::size_t{1} << Precision> Registers{};
+    };
+
+    /// Estimates quantiles of an ordered stream with a KLL sketch: about 3K samples in levels of compactors, each
+    /// halving a sorted full level into the one above. The rank error is around 1.7 / K (under 1% by default).
+    /// Sketches of parts of a stream merge.
+    template<typename V = double>
+    class QuantileSketch
+    {
+    public:
+        explicit QuantileSketch(std::size_t K = 200) : K(std::max<std::size_t>(K, 8)) {}
+
+        /// Adds a value.
+        void Add(const V& Value)
+        {
+            Smallest = Total == 0 || Value < Smallest ? Value : Smallest;
+            Largest = Total == 0 || Largest < Value ? Value : Largest;
+            Levels[0].push_back(Value);
+            ++Total;
+            if (Levels[0].size() >= Capacity(0))
+                Compress();
+        }
+
+        /// Returns an empty sketch with the same K.
+        QuantileSketch Empty() const { return QuantileSketch{K}; }
+
+        /// Combines the sketch of another part of the stream.
+        void Merge(const QuantileSketch& Other)
+        {
+            if (Other.Total == 0)
+                return;
+
+            Smallest = Total == 0 || Other.Smallest < Smallest ? Other.Smallest : Smallest;
+            Largest = Total == 0 || Largest < Other.Largest ? Other.Largest : Largest;
+            if (Levels.size() < Other.Levels.size())
+                Levels.resize(Other.Levels.size());
+
+            for (std::size_t Level = 0; Level < Other.Levels.size(); ++Level)
+                Levels[Level].insert(Levels[Level].end(), Other.Levels[Level].begin(), Other.Levels[Level].end());
+
+            Total += Other.Total;
+            Compress();
+        }
+
+        /// Returns the number of values added.
+        std::size_t Count() const { return Total; }
+
+        /// Returns the estimated values at each of the given quantiles in [0, 1], or none when the sketch is empty;
+        /// quantiles 0 and 1 are the exact minimum and maximum.
+        std::vector<V> Quantiles(const std::vector<double>& Ranks) const
+        {
+            auto Weighted = std::vector<std::pair<V, std::uint64_t>>{};
+            for (std::size_t Level = 0; Level < Levels.size(); ++Level)
+            {
+                for (const auto& Value : Levels[Level])
+                    Weighted.emplace_back(Value, std::uint64_t{1} << Level);
+            }
+
+            auto Result = std::vector<V>{};
+            if (Weighted.empty())
+                return Result;
+
+            std::ranges::sort(Weighted, std::ranges::less{}, [](const auto& Sample) -> const V& { return Sample.first; });
+
+            Result.reserve(Ranks.size());
+            for (auto Rank : Ranks)
+            {
+                if (Rank <= 0.0 || Rank >= 1.0)
+                {
+                    Result.push_back(Rank <= 0.0 ? Smallest : Largest);
+                    continue;
+                }
+
+                auto Target = Rank * static_cast<double>(Total);
+                auto Seen = std::uint64_t{0};
+                auto It = Weighted.begin();
+                while (std::next(It) != Weighted.end() && static_cast<double>(Seen += It->second) < Target)
+                    ++It;
+
+                Result.push_back(It->first);
+            }
+
+            return Result;
+        }
+
+        /// Returns the estimated value at the given quantile in [0, 1]; the sketch must not be empty.
+        V Quantile(double Rank) const { return Quantiles({Rank}).front(); }
+
+    private:
+        // Levels further below the top get geometrically smaller, so the sketch stays around 3K samples
+        std::size_t Capacity(std::size_t Level) const
+        {
+            auto Depth = static_cast<double>(Levels.size() - Level - 1);
+            return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(static_cast<double>(K) * std::pow(2.0 / 3.0, Depth))));
+        }
+
+        // Halves each full level into the next: sorted, then every other sample kept from a random offset
+        void Compress()
+        {
+            for (std::size_t Level = 0; Level < Levels.size(); ++Level)
+            {
+                if (Levels[Level].size() < Capacity(Level))
+                    continue;
+
+                if (Level + 1 == Levels.size())
+                    Levels.emplace_back();
+
+                auto& Current = Levels[Level];
+                std::ranges::sort(Current);
+
+                auto Kept = std::optional<V>{};
+                if (Current.size() % 2)
+                {
+                    Kept.emplace(std::move(Current.back()));
+                    Current.pop_back();
+                }
+
+                Seed ^= Seed << 13;
+                Seed ^= Seed >> 7;
+                Seed ^= Seed << 17;
+                for (auto Index = static_cast<std::size_t>(Seed & 1); Index < Current.size(); Index += 2)
+                    Levels[Level + 1].push_back(std::move(Current[Index]));
+
+                Current.clear();
+                if (Kept)
+                    Current.push_back(std::move(*Kept));
+            }
+        }
+
+        std::size_t K;
+        std::vector<std::vector<V>> Levels = std::vector<std::vector<V>>(1);
+        std::size_t Total = 0;
+        V Smallest{};
+        V Largest{};
+        std::uint64_t Seed = 0x9E3779B97F4A7C15ull;
+    };
+
+    /// Finds the most frequent values with the SpaceSaving algorithm in 'Capacity' counters: any value occurring
+    /// more than Count / Capacity times is kept, and each count overestimates by at most its Error. Sketches of
+    /// parts of a stream merge.
+    template<typename V>
+    class SpaceSaving
+    {
+    public:
+        struct Counter
+        {
+            V Value;
+            std::size_t Count = 0;
+            std::size_t Error = 0;
+        };
+
+        explicit SpaceSaving(std::size_t Capacity = 256) : Capacity(std::max<std::size_t>(Capacity, 1)) {}
+
+        /// Adds one occurrence of a value, replacing the least counted value once every counter is taken.
+        void Add(const V& Value)
+        {
+            if (auto Slot = Positions.find(Value); Slot != Positions.end())
+            {
+                ++Counters[Slot->second].Count;
+                SiftDown(Slot->second);
+            }
+            else if (Counters.size() < Capacity)
+            {
+                Counters.push_back({Value, 1, 0});
+                Positions[Value] = Counters.size() - 1;
+                SiftUp(Counters.size() - 1);
+            }
+            else
+            {
+                // Reuse the evicted value's node, so a stream of new values doesn't allocate one per element
+                auto& Smallest = Counters.front();
+                auto Node = Positions.extract(Smallest.Value);
+                Node.key() = Value;
+                Positions.insert(std::move(Node));
+                Smallest = {Value, Smallest.Count + 1, Smallest.Count};
+                SiftDown(0);
+            }
+        }
+
+        /// Returns an empty sketch with the same capacity.
+        SpaceSaving Empty() const { return SpaceSaving{Capacity}; }
+
+        /// Combines the sketch of another part of the stream: values missing from one side are counted at that
+        /// side's smallest count, then the 'Capacity' largest remain.
+        void Merge(const SpaceSaving& Other)
+        {
+            auto Floor = Counters.size() < Capacity ? 0 : Counters.front().Count;
+            auto OtherFloor = Other.Counters.size() < Other.Capacity ? 0 : Other.Counters.front().Count;
+
+            auto Entries = std::vector<Counter>{};
+            for (const auto& Entry : Counters)
+                Entries.push_back({Entry.Value, Entry.Count + OtherFloor, Entry.Error + OtherFloor});
+
+            for (const auto& Entry : Other.Counters)
+            {
+                if (auto Slot = Positions.find(Entry.Value); Slot != Positions.end())
+                {
+                    Entries[Slot->second].Count += Entry.Count - OtherFloor;
+                    Entries[Slot->second].Error += Entry.Error - OtherFloor;
+                }
+                else
+                {
+                    Entries.push_back({Entry.Value, Entry.Count + Floor, Entry.Error + Floor});
+                }
+            }
+
+            std::ranges::sort(Entries, std::ranges::greater{}, &Counter::Count);
+            Entries.resize(std::min(Entries.size(), Capacity));
+
+            Counters.clear();
+            Positions.clear();
+            for (auto& Entry : Entries)
+            {
+                Counters.push_back(std::move(Entry));
+                Positions[Counters.back().Value] = Counters.size() - 1;
+                SiftUp(Counters.size() - 1);
+            }
+        }
+
+        /// Returns up to K counters, most counted first.
+        std::vector<Counter> Top(std::size_t K) const
+        {
+            auto Result = Counters;
+            auto Middle = Result.begin() + static_cast<std::ptrdiff_t>(std::min(K, Result.size()));
+            std::ranges::partial_sort(Result, Middle, std::ranges::greater{}, &Counter::Count);
+            Result.erase(Middle, Result.end());
+            return Result;
+        }
+
+    private:
+        // Counters form a min-heap on Count, with each value's slot tracked so its counter can be found again
+        void Swap(std::size_t Left, std::size_t Right)
+        {
+            std::swap(Counters[Left], Counters[Right]);
+            Positions[Counters[Left].Value] = Left;
+            Positions[Counters[Right].Value] = Right;
+        }
+
+        void SiftUp(std::size_t Index)
+        {
+            for (; Index > 0 && Counters[Index].Count < Counters[(Index - 1) / 2].Count; Index = (Index - 1) / 2)
+                Swap(Index, (Index - 1) / 2);
+        }
+
+        void SiftDown(std::size_t Index)
+        {
+            while (true)
+            {
+                auto Smallest = Index;
+                for (auto Child : {2 * Index + 1, 2 * Index + 2})
+                {
+                    if (Child < Counters.size() && Counters[Child].Count < Counters[Smallest].Count)
+                        Smallest = Child;
+                }
+
+                if (Smallest == Index)
+                    return;
+
+                Swap(Index, Smallest);
+                Index = Smallest;
+            }
+        }
+
+        std::size_t Capacity;
+        std::vector<Counter> Counters{};
+        std::unordered_map<V, std::size_t> Positions{};
+    };
+
+    namespace Detail
+    {
+        /// Returns an empty sketch configured like the given one: its Empty() when it has one, else a default one.
+        template<typename S>
+        S EmptySketch(const S& Sketch)
+        {
+            if constexpr (requires { { Sketch.Empty() } -> std::convertible_to<S>; })
+                return Sketch.Empty();
+            else
+                return S{};
+        }
+    }
+}
+
+/// A pipeline over a view. Stages on an rvalue stream move the upstream view into the stream they return; on a named
+/// stream they work on a copy of it, leaving it usable, and don't compile when the view can't be copied (e.g. an
+/// owning view of a moved-in container), which has to be passed with std::move.
+template<typename T>
+struct StreamImpl
+{
+    T View{};
+    Stream::ExecutionPolicy Policy{};
+
+    /// Returns the stream with terminals running under the given execution policy.
+    constexpr auto With(Stream::ExecutionPolicy NewPolicy) &&
+    {
+        // An attached profiler stays attached across Par/Seq switches
+        if (!NewPolicy.Profiler)
+            NewPolicy.Profiler = Policy.Profiler;
+
+        return StreamImpl<T>{std::move(View), NewPolicy};
+    }
+
+    constexpr auto With(Stream::ExecutionPolicy NewPolicy) const& requires std::copy_constructible<T> { return StreamImpl(*this).With(std::move(NewPolicy)); }
+
+    /// Returns the stream with terminals fanned out across threads when the view is random access and sized.
+    constexpr auto Par(std::size_t Workers = 0) &&
+    {
+        return std::move(*this).With({.Workers = Workers, .Grain = Policy.Grain});
+    }
+
+    constexpr auto Par(std::size_t Workers = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).Par(std::move(Workers)); }
+
+    /// Returns the stream with terminals split into tasks on the given pool.
+    constexpr auto Par(Stream::ThreadPool& Pool) &&
+    {
+        return std::move(*this).With({.Workers = 0, .Grain = Policy.Grain, .Pool = &Pool});
+    }
+
+    constexpr auto Par(Stream::ThreadPool& Pool) const& requires std::copy_constructible<T> { return StreamImpl(*this).Par(Pool); }
+
+    /// Returns the stream with terminals running on the calling thread.
+    constexpr auto Seq() &&
+    {
+        return std::move(*this).With(Stream::Sequential);
+    }
+
+    constexpr auto Seq() const& requires std::copy_constructible<T> { return StreamImpl(*this).Seq(); }
+
+    /// Checks if terminals should split the view across threads.
+    constexpr bool RunsInParallel()
+    {
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (std::is_constant_evaluated() || Policy.Workers == 1)
+                return false;
+
+            return Stream::Detail::SliceCount(std::ranges::size(View), Policy) > 1;
+        }
+
+        return false;
+    }
+
+    /// Attaches a profiler that the Map/Each/Filter/Reject/Take/SplitBy/Join stages added afterwards record into.
+    /// Without STREAM_PROFILE defined to 1 this only sets the policy and the stages are unchanged.
+    constexpr auto Profile(Stream::Profiler& Target) &&
+    {
+        auto NewPolicy = Policy;
+        NewPolicy.Profiler = &Target;
+        return std::move(*this).With(NewPolicy);
+    }
+
+    constexpr auto Profile(Stream::Profiler& Target) const& requires std::copy_constructible<T> { return StreamImpl(*this).Profile(Target); }
+
+#if STREAM_PROFILE
+    /// Appends a pass-through counting each element this stream yields (each dereference) as the output of a new stage.
+    constexpr auto Counted(std::string_view Kind) &&
+    {
+        auto Stage = Stream::Detail::AddStage(Policy, Kind, true);
+        auto NewView = std::move(View) | std::views::transform([Stage](auto&& Value) -> Stream::Detail::PassedType<decltype(Value)>
+        {
+            if (Stage)
+                Stage->Out.fetch_add(1, std::memory_order_relaxed);
+
+            return std::forward<decltype(Value)>(Value);
+        });
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Counted(std::string_view Kind) const& requires std::copy_constructible<T> { return StreamImpl(*this).Counted(std::move(Kind)); }
+#endif
+
+    /// Hides the pipeline behind a Stream::AnyStream<U>, a single type that can be stored, returned from another
+    /// translation unit or reassigned while a pipeline is built at runtime; elements cross it a batch at a time.
+    template<typename U = std::ranges::range_value_t<T>>
+    auto Erase() &&
+    {
+        return StreamImpl<Stream::Detail::AnyView<U>>{Stream::Detail::AnyView<U>{std::move(View)}, Policy};
+    }
+
+    template<typename U = std::ranges::range_value_t<T>>
+    auto Erase() const& requires std::copy_constructible<T> { return StreamImpl(*this).template Erase<U>(); }
+
+    /// Switches the stream to push mode: the following Map/Filter/Reject/Each stages are fused into one function
+    /// per element, which Collect, Reduce, Run and the other push terminals drive in a single loop. Stages don't fuse
+    /// on their own, since the fused view is input-only and unsized where a Map over a random access view isn't.
+    constexpr auto Fuse() &&
+    {
+        if constexpr (Stream::Detail::Fused<T>)
+            return StreamImpl<T>{std::move(View), Policy};
+        else
+        {
+            auto NewView = Stream::Detail::FusedView{std::move(View)};
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+    }
+
+    constexpr auto Fuse() const& requires std::copy_constructible<T> { return StreamImpl(*this).Fuse(); }
+
+    /// Pushes each element into Sink, stopping early once Sink returns false (sinks returning void take everything).
+    constexpr void Push(auto&& Sink)
+    {
+        if constexpr (Stream::Detail::Pushable<T>)
+            View.Push(Sink);
+        else
+        {
+            for (auto&& Value : View)
+            {
+                if (!Stream::Detail::Emit(Sink, std::forward<decltype(Value)>(Value)))
+                    return;
+            }
+        }
+    }
+
+    /// Pushes every element into Sink without buffering, flushes it and returns it (e.g. to read a counter).
+    /// Sinks are callables and may return false to stop early; see Stream::counter, to, batch and tee.
+    constexpr auto ForEach(auto Sink)
+    {
+        Push(Sink);
+        Stream::Detail::Flush(Sink);
+        return Sink;
+    }
+
+    /// Transforms each element in the view using the provided function.
+    constexpr auto Map(auto Func) &&
+    {
+#if STREAM_PROFILE
+        if constexpr (!Stream::Detail::IsProfiled<decltype(Func)>)
+            return std::move(*this).Map(Stream::Detail::Profiled<false>(std::move(Func), Policy, "Map"));
+        else
+#endif
+        if constexpr (Stream::Detail::Fused<T>)
+        {
+            auto NewView = std::move(View).Map(Func);
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else
+        {
+            auto NewView = std::move(View) | std::views::transform(Func);
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+    }
+
+    constexpr auto Map(auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Map(std::move(Func)); }
+
+    /// Applies a function to each element of the view but returns the original value.
+    constexpr auto Each(auto Func) &&
+    {
+        auto NewFunc = [Func](auto Value)
+        {
+            Func(Value);
+            return Value;
+        };
+#if STREAM_PROFILE
+        return std::move(*this).Map(Stream::Detail::Profiled<false>(std::move(NewFunc), Policy, "Each"));
+#else
+        return std::move(*this).Map(NewFunc);
+#endif
+    }
+
+    constexpr auto Each(auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Each(std::move(Func)); }
+
+    /// Reduces the view to a single value using the provided function, in one pass on the calling thread whatever the
+    /// execution policy; pass a combiner to split the fold across threads.
+    constexpr auto Reduce(auto InitialValue, auto Func)
+    {
+        using AccType = decltype(InitialValue);
+
+        auto Result = [&]() -> AccType
+        {
+            if constexpr (Stream::Detail::Pushable<T>)
+            {
+                auto Acc = InitialValue;
+                View.Push([&](auto&& Value){ Acc = Func(std::move(Acc), std::forward<decltype(Value)>(Value)); });
+                return Acc;
+            }
+
+            return Stream::Detail::Accumulate(std::ranges::begin(View), std::ranges::end(View), InitialValue, Func);
+        }();
+
+        auto NewView = std::views::single(Result);
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    /// Reduces the view like Reduce(InitialValue, Func), but under a parallel policy each slice is folded with 'Func'
+    /// from 'InitialValue', which must be an identity for 'Combine', and the slices' results are joined in order
+    /// with Combine(Left, Right), which must be associative.
+    constexpr auto Reduce(auto InitialValue, auto Func, auto Combine)
+    {
+        using AccType = decltype(InitialValue);
+
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Partials = ParallelSlices([&InitialValue, &Func](auto Begin, auto End)
+                {
+                    return Stream::Detail::Accumulate(Begin, End, InitialValue, Func);
+                });
+
+                auto Result = Stream::Detail::Accumulate(std::next(Partials.begin()), Partials.end(), AccType(std::move(Partials.front())), Combine);
+                auto NewView = std::views::single(std::move(Result));
+                return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+            }
+        }
+
+        return Reduce(std::move(InitialValue), std::move(Func));
+    }
+
+    /// Reduces the view to a single value like Reduce, but only when the resulting stream is first iterated.
+    constexpr auto ReduceLazy(auto InitialValue, auto Func) &&
+    {
+        auto NewView = Stream::Detail::DeferredView{[Upstream = StreamImpl<T>{std::move(View), Policy}, InitialValue, Func]() mutable
+        {
+            return std::move(Upstream.Reduce(InitialValue, Func).View);
+        }};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto ReduceLazy(auto InitialValue, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).ReduceLazy(std::move(InitialValue), std::move(Func)); }
+
+    /// Runs the upstream once into a std::vector the first time the stream is iterated, and serves every later
+    /// iteration from it, including other terminals on this stream and on its copies.
+    constexpr auto Cache() &&
+    {
+        auto NewView = Stream::Detail::DeferredView{[Upstream = StreamImpl<T>{std::move(View), Policy}]() mutable
+        {
+            return Upstream.Collect();
+        }};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Cache() const& requires std::copy_constructible<T> { return StreamImpl(*this).Cache(); }
+
+    /// Caches like Cache() into a container template instantiated with the element type (e.g. std::deque, which
+    /// grows in chunks instead of reallocating and moving everything for large unsized streams).
+    template<template<typename...> typename Container>
+    constexpr auto Cache() &&
+    {
+        auto NewView = Stream::Detail::DeferredView{[Upstream = StreamImpl<T>{std::move(View), Policy}]() mutable
+        {
+            return Upstream.template CollectInto<Container>();
+        }};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    template<template<typename...> typename Container>
+    constexpr auto Cache() const& requires std::copy_constructible<T> { return StreamImpl(*this).template Cache<Container>(); }
+
+    /// Caches like Cache() into a std::pmr::vector allocated from the given resource (e.g. a Stream::Arena).
+    constexpr auto Cache(std::pmr::memory_resource& Resource) &&
+    {
+        auto NewView = Stream::Detail::DeferredView{[Upstream = StreamImpl<T>{std::move(View), Policy}, &Resource]() mutable
+        {
+            return Upstream.template CollectInto<std::pmr::vector<std::ranges::range_value_t<T>>>(&Resource);
+        }};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Cache(std::pmr::memory_resource& Resource) const& requires std::copy_constructible<T> { return StreamImpl(*this).Cache(Resource); }
+
+    /// Lazily yields the running result of reducing each element with the provided function (e.g. running totals).
+    constexpr auto Scan(auto InitialValue, auto Func) &&
+    {
+        auto NewView = Stream::Detail::ScanView{std::move(View), InitialValue, Func};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Scan(auto InitialValue, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Scan(std::move(InitialValue), std::move(Func)); }
+
+    /// Filters elements based on the provided predicate function.
+    constexpr auto Filter(auto Func) &&
+    {
+#if STREAM_PROFILE
+        if constexpr (!Stream::Detail::IsProfiled<decltype(Func)>)
+            return std::move(*this).Filter(Stream::Detail::Profiled<true>(std::move(Func), Policy, "Filter"));
+        else
+#endif
+        if constexpr (Stream::Detail::Fused<T>)
+        {
+            auto NewView = std::move(View).Filter(Func);
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else
+        {
+            auto NewView = std::move(View) | std::views::filter(Func);
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+    }
+
+    constexpr auto Filter(auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Filter(std::move(Func)); }
+
+    /// Filters contiguous views in blocks of 'BlockSize', evaluating Func branch-free into a selection vector per
+    /// block; chained calls narrow the same selection. Other views fall back to Filter.
+    constexpr auto FilterBatch(auto Func, std::size_t BlockSize = 1024) &&
+    {
+#if STREAM_PROFILE
+        if constexpr (!Stream::Detail::IsProfiled<decltype(Func)>)
+            return std::move(*this).FilterBatch(Stream::Detail::Profiled<true>(std::move(Func), Policy, "FilterBatch"), BlockSize);
+        else
+#endif
+        if constexpr (Stream::Detail::IsSelection<T>)
+        {
+            auto NewView = std::move(View).Refine(std::move(Func));
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else if constexpr (std::ranges::contiguous_range<T> && std::ranges::sized_range<T>)
+        {
+            auto NewView = Stream::Detail::SelectBlocks(std::move(View), std::move(Func), BlockSize);
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else
+        {
+            return std::move(*this).Filter(std::move(Func));
+        }
+    }
+
+    constexpr auto FilterBatch(auto Func, std::size_t BlockSize = 1024) const& requires std::copy_constructible<T> { return StreamImpl(*this).FilterBatch(std::move(Func), std::move(BlockSize)); }
+
+    /// Filters out elements that do not satisfy the provided predicate function.
+    constexpr auto Reject(auto Func) &&
+    {
+        auto NewFunc = [Func](auto Value){ return !Func(Value); };
+#if STREAM_PROFILE
+        return std::move(*this).Filter(Stream::Detail::Profiled<true>(std::move(NewFunc), Policy, "Reject"));
+#else
+        return std::move(*this).Filter(NewFunc);
+#endif
+    }
+
+    constexpr auto Reject(auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Reject(std::move(Func)); }
+
+    /// Transforms each element on the pool's workers, keeping the original order; the results are materialized.
+    auto ParMap(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) &&
+    {
+        using ResultType = std::remove_cvref_t<std::invoke_result_t<decltype(Func)&, std::ranges::range_reference_t<T>>>;
+        auto Result = Stream::Detail::ParGather<ResultType>(View, Pool, Grain, [&Func](auto&& Value, auto& Out){ Out.push_back(Func(Value)); });
+        return StreamImpl<std::vector<ResultType>>{std::move(Result), Policy};
+    }
+
+    auto ParMap(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).ParMap(std::move(Func), Pool, Grain); }
+
+    /// Filters elements on the pool's workers, keeping the original order; the results are materialized.
+    auto ParFilter(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) &&
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        auto Result = Stream::Detail::ParGather<ValueType>(View, Pool, Grain, [&Func](auto&& Value, auto& Out){ if (Func(Value)) Out.push_back(Value); });
+        return StreamImpl<std::vector<ValueType>>{std::move(Result), Policy};
+    }
+
+    auto ParFilter(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).ParFilter(std::move(Func), Pool, Grain); }
+
+    /// Filters out elements on the pool's workers, keeping the original order; the results are materialized.
+    auto ParReject(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) &&
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        auto Result = Stream::Detail::ParGather<ValueType>(View, Pool, Grain, [&Func](auto&& Value, auto& Out){ if (!Func(Value)) Out.push_back(Value); });
+        return StreamImpl<std::vector<ValueType>>{std::move(Result), Policy};
+    }
+
+    auto ParReject(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).ParReject(std::move(Func), Pool, Grain); }
+
+    /// Applies a function to each element on the pool's workers and returns the original values in order.
+    auto ParEach(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) &&
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        auto Result = Stream::Detail::ParGather<ValueType>(View, Pool, Grain, [&Func](auto&& Value, auto& Out){ Func(Value); Out.push_back(Value); });
+        return StreamImpl<std::vector<ValueType>>{std::move(Result), Policy};
+    }
+
+    auto ParEach(auto Func, Stream::ThreadPool& Pool, std::size_t Grain = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).ParEach(std::move(Func), Pool, Grain); }
+
+    /// Takes the first 'Count' elements from the view.
+    constexpr auto Take(auto Count) &&
+    {
+        auto NewView = std::move(View) | std::views::take(Count);
+#if STREAM_PROFILE
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy}.Counted("Take");
+#else
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+#endif
+    }
+
+    constexpr auto Take(auto Count) const& requires std::copy_constructible<T> { return StreamImpl(*this).Take(std::move(Count)); }
+
+    /// Splits the view by the given token (an element or a sequence of elements).
+    /// Contiguous byte data (e.g. chars) is scanned with memchr and split into std::string_view pieces.
+    constexpr auto SplitBy(auto Token) &&
+    {
+        if constexpr (Stream::Detail::ByteToken<T, decltype(Token)>)
+        {
+            auto NewView = Stream::Detail::ByteSplitView{std::move(View), Token};
+#if STREAM_PROFILE
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy}.Counted("SplitBy");
+#else
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+#endif
+        }
+        else
+        {
+            auto NewView = std::move(View) | std::views::split(Token);
+#if STREAM_PROFILE
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy}.Counted("SplitBy");
+#else
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+#endif
+        }
+    }
+
+    constexpr auto SplitBy(auto Token) const& requires std::copy_constructible<T> { return StreamImpl(*this).SplitBy(std::move(Token)); }
+
+    /// Joins nested ranges into a single range.
+    constexpr auto Join() &&
+    {
+        auto NewView = std::move(View) | std::views::join;
+#if STREAM_PROFILE
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy}.Counted("Join");
+#else
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+#endif
+    }
+
+    constexpr auto Join() const& requires std::copy_constructible<T> { return StreamImpl(*this).Join(); }
+
+    /// Keeps only the given fields of tuple-like elements. Over Stream::columns it selects whole columns instead,
+    /// and a single column becomes a contiguous std::span, so Sum and the other contiguous kernels apply to it.
+    template<std::size_t... I>
+    constexpr auto Project() &&
+    {
+        static_assert(sizeof...(I) > 0, "Project needs at least one field");
+
+        if constexpr (Stream::Detail::IsColumns<T> && sizeof...(I) == 1)
+        {
+            auto NewView = View.template Column<I...>();
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else if constexpr (Stream::Detail::IsColumns<T>)
+        {
+            auto NewView = Stream::Detail::ColumnsView{View.template Column<I>()...};
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else if constexpr (sizeof...(I) == 1)
+        {
+            auto NewView = std::move(View) | std::views::elements<I...>;
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+        else
+        {
+            auto NewView = std::move(View) | std::views::transform([](const auto& Value){ return std::tuple{std::get<I>(Value)...}; });
+            return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+        }
+    }
+
+    template<std::size_t... I>
+    constexpr auto Project() const& requires std::copy_constructible<T> { return StreamImpl(*this).template Project<I...>(); }
+
+    /// Returns the keys of the view.
+    constexpr auto Keys() &&
+    {
+        auto NewView = std::move(View) | std::views::keys;
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Keys() const& requires std::copy_constructible<T> { return StreamImpl(*this).Keys(); }
+
+    /// Returns the values of the view.
+    constexpr auto Values() &&
+    {
+        auto NewView = std::move(View) | std::views::values;
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Values() const& requires std::copy_constructible<T> { return StreamImpl(*this).Values(); }
+
+    /// Checks if all elements satisfy the provided predicate function, stopping at the first that doesn't.
+    constexpr auto All(auto Func)
+    {
+        if constexpr (Stream::Detail::Pushable<T>)
+            return !Any([&Func](const auto& Value){ return !Func(Value); });
+        else
+            return std::ranges::all_of(View, Func);
+    }
+
+    /// Checks if any element satisfies the provided predicate function, stopping at the first that does.
+    constexpr auto Any(auto Func)
+    {
+        if constexpr (Stream::Detail::Pushable<T>)
+        {
+            auto Found = false;
+            View.Push([&](const auto& Value){ return !(Found = static_cast<bool>(Func(Value))); });
+            return Found;
+        }
+        else
+        {
+            return std::ranges::any_of(View, Func);
+        }
+    }
+
+    /// Checks if no element satisfies the provided predicate function, stopping at the first that does.
+    constexpr auto None(auto Func)
+    {
+        return !Any(Func);
+    }
+
+    /// Returns the first element that satisfies the provided predicate function, if any.
+    constexpr auto Find(auto Func)
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+
+        auto It = std::ranges::find_if(View, Func);
+        if (It == std::ranges::end(View))
+            return std::optional<ValueType>{};
+
+        return std::optional<ValueType>{*It};
+    }
+
+    /// Returns the index of the first element that satisfies the provided predicate function, if any.
+    constexpr auto FindIndex(auto Func)
+    {
+        using IndexType = std::ranges::range_difference_t<T>;
+
+        auto Index = IndexType{0};
+        for (auto&& Value : View)
+        {
+            if (Func(Value))
+                return std::optional<IndexType>{Index};
+
+            ++Index;
+        }
+
+        return std::optional<IndexType>{};
+    }
+
+    /// Returns unique elements in a single pass, keeping the first occurrence of each value. The result is an
+    /// input range: stages and terminals after it that need a forward range (e.g. ChunkWhile, Window) don't apply.
+    constexpr auto Uniq(std::size_t CapacityHint = 0) &&
+    {
+        return std::move(*this).UniqBy(std::identity{}, CapacityHint);
+    }
+
+    constexpr auto Uniq(std::size_t CapacityHint = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).Uniq(std::move(CapacityHint)); }
+
+    /// Returns elements whose key (as computed by the provided function) has not been seen before.
+    constexpr auto UniqBy(auto KeyFunc, std::size_t CapacityHint = 0) &&
+    {
+        auto NewView = Stream::Detail::UniqView{std::move(View), KeyFunc, CapacityHint};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto UniqBy(auto KeyFunc, std::size_t CapacityHint = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).UniqBy(std::move(KeyFunc), std::move(CapacityHint)); }
+
+    /// Pairs each element with its index, counting from the given offset.
+    template<std::integral I = int>
+    constexpr auto WithIndex(I Offset = 0) &&
+    {
+        auto NewView = Stream::Detail::EnumerateView{std::move(View), Offset};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    template<std::integral I = int>
+    constexpr auto WithIndex(I Offset = 0) const& requires std::copy_constructible<T> { return StreamImpl(*this).template WithIndex<I>(std::move(Offset)); }
+
+    /// Walks this stream in lockstep with other streams or ranges, yielding std::tuples until the shortest ends;
+    /// random access and sized when all of them are, with nothing materialized.
+    constexpr auto Zip(auto&&... Others) &&
+    {
+        auto NewView = Stream::Detail::ZipView{std::move(View), Stream::Detail::ViewOf(std::forward<decltype(Others)>(Others))...};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Zip(auto&&... Others) const& requires std::copy_constructible<T> { return StreamImpl(*this).Zip(std::forward<decltype(Others)>(Others)...); }
+
+    /// Combines the elements of this stream and other streams or ranges in lockstep with Func(Element, Others...).
+    constexpr auto ZipWith(auto Func, auto&&... Others) &&
+    {
+        return std::move(*this).Zip(std::forward<decltype(Others)>(Others)...).Map([Func = std::move(Func)](auto&& Row)
+        {
+            return std::apply(Func, std::forward<decltype(Row)>(Row));
+        });
+    }
+
+    constexpr auto ZipWith(auto Func, auto&&... Others) const& requires std::copy_constructible<T> { return StreamImpl(*this).ZipWith(std::move(Func), std::forward<decltype(Others)>(Others)...); }
+
+    /// Appends the elements of other streams or ranges after this stream's.
+    constexpr auto Concat(auto&&... Others) &&
+    {
+        auto NewView = Stream::Detail::ConcatView{std::move(View), Stream::Detail::ViewOf(std::forward<decltype(Others)>(Others))...};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Concat(auto&&... Others) const& requires std::copy_constructible<T> { return StreamImpl(*this).Concat(std::forward<decltype(Others)>(Others)...); }
+
+    /// Alternates between the elements of this stream and other streams or ranges, continuing with the longer ones.
+    constexpr auto Interleave(auto&&... Others) &&
+    {
+        auto NewView = Stream::Detail::InterleaveView{std::move(View), Stream::Detail::ViewOf(std::forward<decltype(Others)>(Others))...};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Interleave(auto&&... Others) const& requires std::copy_constructible<T> { return StreamImpl(*this).Interleave(std::forward<decltype(Others)>(Others)...); }
+
+    /// Returns the minimum element in the view, or nothing if the view is empty.
+    constexpr auto Min()
+    {
+        using ResultType = std::optional<std::ranges::range_value_t<T>>;
+
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Scan = [](auto Begin, auto End)
+                {
+                    auto Found = std::ranges::min_element(Begin, End);
+                    return Found == End ? ResultType{} : ResultType{*Found};
+                };
+
+                auto Result = ResultType{};
+                for (auto& Partial : ParallelSlices(Scan))
+                {
+                    if (Partial && (!Result || *Partial < *Result))
+                        Result = std::move(Partial);
+                }
+
+                return Result;
+            }
+        }
+
+        // A single pass, so input-only views (Uniq, Fuse, Erase, FilterBatch) work too
+        auto Result = ResultType{};
+        for (auto&& Value : View)
+        {
+            if (!Result || Value < *Result)
+                Result = std::forward<decltype(Value)>(Value);
+        }
+
+        return Result;
+    }
+
+    /// Returns the maximum element in the view, or nothing if the view is empty.
+    constexpr auto Max()
+    {
+        using ResultType = std::optional<std::ranges::range_value_t<T>>;
+
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Scan = [](auto Begin, auto End)
+                {
+                    auto Found = std::ranges::max_element(Begin, End);
+                    return Found == End ? ResultType{} : ResultType{*Found};
+                };
+
+                auto Result = ResultType{};
+                for (auto& Partial : ParallelSlices(Scan))
+                {
+                    if (Partial && (!Result || *Result < *Partial))
+                        Result = std::move(Partial);
+                }
+
+                return Result;
+            }
+        }
+
+        // A single pass, so input-only views (Uniq, Fuse, Erase, FilterBatch) work too
+        auto Result = ResultType{};
+        for (auto&& Value : View)
+        {
+            if (!Result || *Result < Value)
+                Result = std::forward<decltype(Value)>(Value);
+        }
+
+        return Result;
+    }
+
+    /// Returns the minimum and maximum elements in a single pass, or nothing if the view is empty.
+    constexpr auto MinMax()
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        using ResultType = std::optional<std::pair<ValueType, ValueType>>;
+
+        auto Scan = [](auto Begin, auto End)
+        {
+            auto Result = ResultType{};
+            for (; Begin != End; ++Begin)
+            {
+                ValueType Value = *Begin;
+                if (!Result)
+                    Result.emplace(Value, Value);
+                else if (Value < Result->first)
+                    Result->first = std::move(Value);
+                else if (Result->second < Value)
+                    Result->second = std::move(Value);
+            }
+
+            return Result;
+        };
+
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Result = ResultType{};
+                for (auto& Partial : ParallelSlices(Scan))
+                {
+                    if (!Result)
+                        Result = std::move(Partial);
+                    else if (Partial)
+                    {
+                        if (Partial->first < Result->first)
+                            Result->first = std::move(Partial->first);
+                        if (Result->second < Partial->second)
+                            Result->second = std::move(Partial->second);
+                    }
+                }
+
+                return Result;
+            }
+        }
+
+        return Scan(std::ranges::begin(View), std::ranges::end(View));
+    }
+
+    /// Returns count, sum, min, max, mean and variance computed in a single pass, or nothing if the view is empty.
+    constexpr auto Stats()
+    {
+        using StatsType = Stream::Statistics<std::ranges::range_value_t<T>>;
+
+        auto Scan = [](auto Begin, auto End)
+        {
+            auto Result = StatsType{};
+            for (; Begin != End; ++Begin)
+                Result.Add(*Begin);
+
+            return Result;
+        };
+
+        auto Result = [&]
+        {
+            if constexpr (Stream::Detail::Splittable<T>)
+            {
+                if (RunsInParallel())
+                {
+                    auto Merged = StatsType{};
+                    for (auto& Partial : ParallelSlices(Scan))
+                        Merged.Merge(Partial);
+
+                    return Merged;
+                }
+            }
+
+            return Scan(std::ranges::begin(View), std::ranges::end(View));
+        }();
+
+        return Result.Count ? std::optional<StatsType>{Result} : std::optional<StatsType>{};
+    }
+
+    /// Adds every element to a copy of the given mergeable sketch (HyperLogLog, QuantileSketch, SpaceSaving or any
+    /// type with Add and Merge) and returns it; under a parallel policy each slice fills an empty sketch configured
+    /// like it (from its Empty() member, or default-constructed), then each merges into it once.
+    template<typename S>
+    auto Summarize(S Sketch)
+    {
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Partials = ParallelSlices([&Sketch](auto Begin, auto End)
+                {
+                    auto Partial = Stream::Detail::EmptySketch(Sketch);
+                    for (; Begin != End; ++Begin)
+                        Partial.Add(*Begin);
+
+                    return Partial;
+                });
+
+                for (auto& Partial : Partials)
+                    Sketch.Merge(Partial);
+
+                return Sketch;
+            }
+        }
+
+        Push([&Sketch](const auto& Value){ Sketch.Add(Value); });
+        return Sketch;
+    }
+
+    /// Estimates the number of distinct elements in 2^Precision bytes with a HyperLogLog sketch (1.6% error by default).
+    template<std::size_t Precision = 12>
+    auto ApproxCountDistinct()
+    {
+        return static_cast<std::size_t>(std::llround(Summarize(Stream::HyperLogLog<Precision>{}).Estimate()));
+    }
+
+    /// Estimates the elements at the given quantiles in [0, 1] with a KLL sketch of about 3K samples (empty when the
+    /// stream is).
+    auto ApproxQuantiles(const std::vector<double>& Ranks, std::size_t K = 200)
+    {
+        return Summarize(Stream::QuantileSketch<std::ranges::range_value_t<T>>{K}).Quantiles(Ranks);
+    }
+
+    /// Estimates the K most frequent elements and their counts with a SpaceSaving sketch of 'Capacity' counters
+    /// (by default 8K), most frequent first; counts overestimate by at most the Error each carries.
+    auto ApproxTopK(std::size_t K, std::size_t Capacity = 0)
+    {
+        return Summarize(Stream::SpaceSaving<std::ranges::range_value_t<T>>{Capacity ? Capacity : 8 * K}).Top(K);
+    }
+
+    /// Returns the sum of all elements in the view, accumulated in 'Acc' (by default 64-bit for integers, the element type otherwise).
+    template<typename Acc = void>
+    constexpr auto Sum(Stream::Summation Mode = Stream::Summation::Fast)
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        using AccType = std::conditional_t<std::is_void_v<Acc>, Stream::Detail::SumType<ValueType>, Acc>;
+
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Partials = ParallelSlices([Mode](auto Begin, auto End){ return Stream::Detail::Sum<AccType>(Begin, End, Mode); });
+                return Stream::Detail::Sum<AccType>(Partials.begin(), Partials.end(), Mode);
+            }
+        }
+
+        if constexpr (Stream::Detail::Pushable<T>)
+        {
+            if (Mode == Stream::Summation::Fast)
+            {
+                auto Result = AccType{};
+                View.Push([&Result](const auto& Value){ Result += static_cast<AccType>(Value); });
+                return Result;
+            }
+        }
+
+        return Stream::Detail::Sum<AccType>(std::ranges::begin(View), std::ranges::end(View), Mode);
+    }
+
+    /// Checks if the view contains a specific value.
+    constexpr auto Contains(auto Value)
+    {
+        return Count(Value) > 0;
+    }
+
+    /// Returns the number of elements in the view.
+    constexpr auto Count()
+    {
+        if constexpr (Stream::Detail::Pushable<T>)
+        {
+            auto Result = std::ranges::range_difference_t<T>{0};
+            View.Push([&Result](const auto&){ ++Result; });
+            return Result;
+        }
+        else
+        {
+            return std::ranges::distance(View);
+        }
+    }
+
+    /// Counts the occurrences of a specific value in the view.
+    constexpr auto Count(auto Value)
+    {
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            if (RunsInParallel())
+            {
+                auto Partials = ParallelSlices([&Value](auto Begin, auto End){ return std::ranges::count(Begin, End, Value); });
+                return std::accumulate(Partials.begin(), Partials.end(), std::ranges::range_difference_t<T>{0});
+            }
+        }
+
+        return std::ranges::count(View, Value);
+    }
+
+    /// Chunks the view into sub ranges of a given size, which must be positive; chunks of an input-only view are
+    /// read into a buffer that each step reuses.
+    constexpr auto ChunkEvery(auto Count) &&
+    {
+        if (Count <= decltype(Count){0})
+            throw std::invalid_argument("Stream::ChunkEvery: count must be positive");
+
+#if defined(__cpp_lib_ranges_chunk)
+        auto NewView = std::move(View) | std::views::chunk(Count);
+#else
+        auto NewView = [&]
+        {
+            if constexpr (std::ranges::forward_range<T>)
+                return Stream::Detail::ChunkView{std::move(View), Count};
+            else
+                return Stream::Detail::InputChunkView{std::move(View), Count};
+        }();
+#endif
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto ChunkEvery(auto Count) const& requires std::copy_constructible<T> { return StreamImpl(*this).ChunkEvery(std::move(Count)); }
+
+    /// Chunks the view, starting a new sub range whenever the predicate returns false for two adjacent elements.
+    constexpr auto ChunkWhile(auto Func) &&
+    {
+#if defined(__cpp_lib_ranges_chunk_by)
+        auto NewView = std::move(View) | std::views::chunk_by(Func);
+#else
+        auto NewView = Stream::Detail::ChunkByView{std::move(View), Func};
+#endif
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto ChunkWhile(auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).ChunkWhile(std::move(Func)); }
+
+    /// Returns every window of 'Count' consecutive elements, sliding by one element; 'Count' must be positive.
+    constexpr auto Window(auto Count) &&
+    {
+        if (Count <= decltype(Count){0})
+            throw std::invalid_argument("Stream::Window: count must be positive");
+
+#if defined(__cpp_lib_ranges_slide)
+        auto NewView = std::move(View) | std::views::slide(Count);
+#else
+        auto NewView = Stream::Detail::SlideView{std::move(View), Count};
+#endif
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Window(auto Count) const& requires std::copy_constructible<T> { return StreamImpl(*this).Window(std::move(Count)); }
+
+    /// Folds every 'Count' consecutive elements into one aggregate with Func(Acc, Element), starting from
+    /// InitialValue; a trailing partial window is emitted when the view ends.
+    constexpr auto Tumbling(std::size_t Count, auto InitialValue, auto Func) &&
+    {
+        auto Window = Stream::Detail::TumblingCount<decltype(InitialValue), decltype(Func)>{std::max<std::size_t>(Count, 1), InitialValue, Func};
+        auto NewView = Stream::Detail::WindowView{std::move(View), std::move(Window)};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Tumbling(std::size_t Count, auto InitialValue, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Tumbling(std::move(Count), std::move(InitialValue), std::move(Func)); }
+
+    /// Yields Func folded over each window of 'Count' consecutive elements, sliding by one, in O(1) amortized per
+    /// element; Func must be associative over the element type (e.g. sum, min, max).
+    constexpr auto Sliding(std::size_t Count, auto Func) &&
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+
+        auto Window = Stream::Detail::SlidingCount<ValueType, decltype(Func)>{std::max<std::size_t>(Count, 1), Stream::Detail::TwoStackQueue<ValueType, decltype(Func)>{Func}};
+        auto NewView = Stream::Detail::WindowView{std::move(View), std::move(Window)};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto Sliding(std::size_t Count, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).Sliding(std::move(Count), std::move(Func)); }
+
+    /// Folds elements into consecutive windows spanning 'Width' of the time TimeFunc reads from each element
+    /// (a number or a std::chrono::time_point, not decreasing), emitting each window once an element past it arrives.
+    constexpr auto TumblingBy(auto TimeFunc, auto Width, auto InitialValue, auto Func) &&
+    {
+        using TimeType = std::remove_cvref_t<std::invoke_result_t<decltype(TimeFunc)&, std::ranges::range_reference_t<T>>>;
+
+        auto Window = Stream::Detail::TumblingTime<decltype(InitialValue), decltype(Func), decltype(TimeFunc), decltype(Width), TimeType>{TimeFunc, Width, InitialValue, Func};
+        auto NewView = Stream::Detail::WindowView{std::move(View), std::move(Window)};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto TumblingBy(auto TimeFunc, auto Width, auto InitialValue, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).TumblingBy(std::move(TimeFunc), std::move(Width), std::move(InitialValue), std::move(Func)); }
+
+    /// Yields, for each element, Func folded over the elements less than 'Width' older than it by the time TimeFunc
+    /// reads from them, in O(1) amortized per element; Func must be associative over the element type.
+    constexpr auto SlidingBy(auto TimeFunc, auto Width, auto Func) &&
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+
+        auto Queue = Stream::Detail::TwoStackQueue<ValueType, decltype(Func)>{Func};
+        auto Window = Stream::Detail::SlidingTime<ValueType, decltype(Func), decltype(TimeFunc), decltype(Width)>{TimeFunc, Width, std::move(Queue)};
+        auto NewView = Stream::Detail::WindowView{std::move(View), std::move(Window)};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    constexpr auto SlidingBy(auto TimeFunc, auto Width, auto Func) const& requires std::copy_constructible<T> { return StreamImpl(*this).SlidingBy(std::move(TimeFunc), std::move(Width), std::move(Func)); }
+
+    /// Sorts the elements (not stably) when the resulting stream is first iterated, splitting the sort across
+    /// threads under a parallel execution policy.
+    template<typename C = std::ranges::less>
+    constexpr auto Sort(C Compare = {}) &&
+    {
+        auto NewView = Stream::Detail::DeferredView{[Upstream = StreamImpl<T>{std::move(View), Policy}, Compare]() mutable
+        {
+            auto Result = Upstream.Collect();
+            Stream::Detail::Sort(Result, Compare, Upstream.Policy);
+            return Result;
+        }};
+        return StreamImpl<decltype(NewView)>{std::move(NewView), Policy};
+    }
+
+    template<typename C = std::ranges::less>
+    constexpr auto Sort(C Compare = {}) const& requires std::copy_constructible<T> { return StreamImpl(*this).template Sort<C>(std::move(Compare)); }
+
+    /// Sorts the elements by the key the provided function returns, like Sort.
+    template<typename C = std::ranges::less>
+    constexpr auto SortBy(auto KeyFunc, C Compare = {}) &&
+    {
+        return std::move(*this).Sort([KeyFunc, Compare](const auto& Left, const auto& Right)
+        {
+            return std::invoke(Compare, std::invoke(KeyFunc, Left), std::invoke(KeyFunc, Right));
+        });
+    }
+
+    template<typename C = std::ranges::less>
+    constexpr auto SortBy(auto KeyFunc, C Compare = {}) const& requires std::copy_constructible<T> { return StreamImpl(*this).template SortBy<C>(std::move(KeyFunc), std::move(Compare)); }
+
+    /// Returns the first 'K' elements in 'Compare' order (the 'K' largest by default) without sorting the whole view.
+    template<typename C = std::ranges::greater>
+    auto TopK(std::size_t K, C Compare = {})
+    {
+        if constexpr (Stream::Detail::Splittable<T>)
+        {
+            // Each slice keeps its own top 'K', and the union of those holds the overall top 'K'
+            if (RunsInParallel())
+            {
+                auto Partials = ParallelSlices([&](auto Begin, auto End){ return Stream::Detail::TopK(Begin, End, K, Compare); });
+                auto Merged = std::vector<std::ranges::range_value_t<T>>{};
+                for (auto& Partial : Partials)
+                    Merged.insert(Merged.end(), std::make_move_iterator(Partial.begin()), std::make_move_iterator(Partial.end()));
+
+                return Stream::Detail::TopK(Merged.begin(), Merged.end(), K, Compare);
+            }
+        }
+
+        return Stream::Detail::TopK(std::ranges::begin(View), std::ranges::end(View), K, Compare);
+    }
+
+    /// Returns the 'K' elements with the smallest keys, in ascending key order.
+    auto MinBy(std::size_t K, auto KeyFunc)
+    {
+        return TopK(K, [KeyFunc](const auto& Left, const auto& Right){ return std::invoke(KeyFunc, Left) < std::invoke(KeyFunc, Right); });
+    }
+
+    /// Returns the 'K' elements with the largest keys, in descending key order.
+    auto MaxBy(std::size_t K, auto KeyFunc)
+    {
+        return TopK(K, [KeyFunc](const auto& Left, const auto& Right){ return std::invoke(KeyFunc, Right) < std::invoke(KeyFunc, Left); });
+    }
+
+    /// Groups the elements by the key the provided function returns, keeping their order within each group.
+    /// Returns a Stream::FlatMap of key to std::vector for hashable keys and a std::map otherwise.
+    auto GroupBy(auto KeyFunc)
+    {
+        using KeyType = std::remove_cvref_t<std::invoke_result_t<decltype(KeyFunc)&, std::ranges::range_reference_t<T>>>;
+
+        auto Result = Stream::GroupMap<KeyType, std::vector<std::ranges::range_value_t<T>>>{};
+        for (auto&& Value : View)
+        {
+            auto& Group = Result[std::invoke(KeyFunc, std::as_const(Value))];
+            Group.push_back(std::forward<decltype(Value)>(Value));
+        }
+
+        return Result;
+    }
+
+    /// Counts the occurrences of each distinct element, in a map like GroupBy's.
+    auto Frequencies()
+    {
+        auto Result = Stream::GroupMap<std::ranges::range_value_t<T>, std::size_t>{};
+        for (auto&& Value : View)
+            ++Result[Value];
+
+        return Result;
+    }
+
+    /// Collects the view elements into a std::vector, reserving 'CapacityHint' slots when the view size isn't known.
+    constexpr auto Collect(std::size_t CapacityHint = 0)
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+
+        if constexpr (Stream::Detail::Splittable<T> && std::default_initializable<ValueType> && std::is_copy_assignable_v<ValueType>)
+        {
+            // Pre-size the result so each thread writes its own slice of slots
+            if (RunsInParallel())
+            {
+                auto Begin = std::ranges::begin(View);
+                auto Result = std::vector<ValueType>(std::ranges::size(View));
+
+                Stream::Detail::ParallelFor(Result.size(), Stream::Detail::SliceCount(Result.size(), Policy), Policy, [&](auto, auto First, auto Last)
+                {
+                    using DifferenceType = std::ranges::range_difference_t<T>;
+                    std::copy(Begin + DifferenceType(First), Begin + DifferenceType(Last), Result.begin() + DifferenceType(First));
+                });
+                return Result;
+            }
+        }
+
+        std::vector<ValueType> Result;
+        CollectTo(Result, CapacityHint);
+        return Result;
+    }
+
+    /// Collects the view elements into a new container built from the given arguments (e.g. an allocator or memory resource).
+    template<typename Container>
+    constexpr auto CollectInto(auto&&... Args)
+    {
+        auto Result = Container(std::forward<decltype(Args)>(Args)...);
+        CollectTo(Result);
+        return Result;
+    }
+
+    /// Collects the view elements into a new container template instantiated with the element type (e.g. std::set).
+    template<template<typename...> typename Container>
+    constexpr auto CollectInto(auto&&... Args)
+    {
+        return CollectInto<Container<std::ranges::range_value_t<T>>>(std::forward<decltype(Args)>(Args)...);
+    }
+
+    /// Collects the first N elements into a std::array, so a whole pipeline can produce a constant; throws
+    /// std::length_error (a compile error in constant evaluation) if the stream ends before N.
+    template<std::size_t N>
+    constexpr auto Collect()
+    {
+        auto Result = std::array<std::ranges::range_value_t<T>, N>{};
+        auto Size = std::size_t{0};
+        if constexpr (N > 0)
+        {
+            Push([&](auto&& Value)
+            {
+                Result[Size++] = std::forward<decltype(Value)>(Value);
+                return Size < N;
+            });
+        }
+
+        if (Size < N)
+            throw std::length_error("Stream::Collect: fewer elements than the array holds");
+
+        return Result;
+    }
+
+    /// Appends the view elements to an existing container, so a buffer can be reused across streams.
+    template<typename Container>
+    constexpr Container& CollectTo(Container& Result, std::size_t CapacityHint = 0)
+    {
+        // Reserve space if the view size is known (e.g., random access or sized ranges), growing at least
+        // geometrically so appending many small streams to one buffer stays linear
+        if constexpr (requires { Result.reserve(std::size_t{}); })
+        {
+            const auto Reserve = [&Result](std::size_t Needed)
+            {
+                if constexpr (requires { Result.capacity(); })
+                {
+                    if (Result.capacity() < Needed)
+                        Result.reserve(std::max<std::size_t>(Needed, 2 * Result.capacity()));
+                }
+                else
+                {
+                    Result.reserve(Needed);
+                }
+            };
+
+            if constexpr (std::ranges::sized_range<T>)
+                Reserve(Result.size() + std::ranges::size(View));
+            else if (CapacityHint)
+                Reserve(Result.size() + CapacityHint);
+        }
+
+        if constexpr (Stream::Detail::Pushable<T> && requires { Result.push_back(*std::ranges::begin(View)); })
+        {
+            View.Push([&Result](auto&& Value){ Result.push_back(std::forward<decltype(Value)>(Value)); });
+        }
+        else if constexpr (Stream::Detail::Pushable<T>)
+        {
+            View.Push([&Result](auto&& Value){ Result.insert(std::forward<decltype(Value)>(Value)); });
+        }
+        else if constexpr (requires { Result.push_back(*std::ranges::begin(View)); })
+        {
+            std::ranges::copy(View, std::back_inserter(Result));
+        }
+        else
+        {
+            for (auto&& Value : View)
+                Result.insert(std::forward<decltype(Value)>(Value));
+        }
+
+        return Result;
+    }
+
+    /// Runs Func(Begin, End) over each parallel slice of the view and returns the per-slice results in order.
+    auto ParallelSlices(auto Func) requires Stream::Detail::Splittable<T>
+    {
+        auto Begin = std::ranges::begin(View);
+        auto Size = std::ranges::size(View);
+        auto Slices = Stream::Detail::SliceCount(Size, Policy);
+
+        using PartialType = decltype(Func(Begin, Begin));
+        auto Partials = std::vector<std::optional<PartialType>>(Slices);
+
+        Stream::Detail::ParallelFor(Size, Slices, Policy, [&](auto Slot, auto First, auto Last)
+        {
+            using DifferenceType = std::ranges::range_difference_t<T>;
+            Partials[Slot].emplace(Func(Begin + DifferenceType(First), Begin + DifferenceType(Last)));
+        });
+
+        auto Result = std::vector<PartialType>{};
+        Result.reserve(Slices);
+        for (auto& Partial : Partials)
+            Result.push_back(std::move(*Partial));
+
+        return Result;
+    }
+
+#if STREAM_FILES
+    /// Writes the elements to a file descriptor as checksummed blocks of about 'BlockSize' bytes, optionally LZ4
+    /// compressed, for Stream::read to map back (on this node or one with the same byte order); returns the count.
+    auto WriteTo(int Descriptor, Stream::Compression Codec = Stream::Compression::None, std::size_t BlockSize = 1 << 20)
+    {
+        using ValueType = std::ranges::range_value_t<T>;
+        return ForEach(Stream::Detail::BlockSink<ValueType>{Descriptor, Codec, BlockSize}).Count();
+    }
 
-    /// Transforms each element in the view using the provided function.
-    constexpr auto Map(auto Func)
+    /// Writes the elements to a new file (replacing an existing one) like WriteTo(Descriptor).
+    auto WriteTo(const std::filesystem::path& Path, Stream::Compression Codec = Stream::Compression::None, std::size_t BlockSize = 1 << 20)
     {
-        auto NewView = View | std::views::transform(Func);
-        return StreamImpl<decltype(NewView)>{NewView};
+#if defined(_WIN32)
+        auto Descriptor = ::_wopen(Path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        auto Descriptor = ::open(Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (Descriptor < 0)
+            throw std::system_error(errno, std::generic_category(), "Stream::WriteTo: " + Path.string());
+
+        auto File = Stream::Detail::DescriptorGuard{Descriptor};
+        return WriteTo(File.Get(), Codec, BlockSize);
     }
+#endif
 
-    /// Applies a function to each element of the view but returns the original value.
-    constexpr auto Each(auto Func)
+    /// Pushes the elements into a ring in batches of 'BatchSize', waiting while it is full, then closes this
+    /// producer's side of it; run it on its own thread with a consumer on another stream built by Stream::from.
+    template<typename U>
+    void Into(Stream::Ring<U>& Target, std::size_t BatchSize = 256)
     {
-        return Map([Func](auto Value)
+        auto Batch = std::vector<U>{};
+        Batch.reserve(std::max<std::size_t>(BatchSize, 1));
+
+        try
         {
-            Func(Value);
-            return Value;
-        });
+            Push([&](auto&& Value)
+            {
+                Batch.push_back(std::forward<decltype(Value)>(Value));
+                if (Batch.size() >= BatchSize)
+                {
+                    Target.Push(Batch);
+                    Batch.clear();
+                }
+            });
+            Target.Push(Batch);
+        }
+        catch (...)
+        {
+            Target.Close();
+            throw;
+        }
+
+        Target.Close();
     }
 
-    /// Reduces the view to a single value using the provided function.
-    constexpr auto Reduce(auto InitialValue, auto Func)
+    /// Runs the stream operations for their side effects, pulling every element through without storing it.
+    constexpr void Run()
     {
-        auto Result = std::accumulate(View.begin(), View.end(), InitialValue, Func);
-        auto NewView = std::views::single(Result);
-        return StreamImpl<decltype(NewView)>{NewView};
+        Push([](auto&&){});
     }
+};
 
-    /// Filters elements based on the provided predicate function.
-    constexpr auto Filter(auto Func)
+namespace Stream
+{
+    /// A stream of T of any pipeline, see StreamImpl::Erase.
+    template<typename T>
+    using AnyStream = StreamImpl<Detail::AnyView<T>>;
+
+    /// Creates a stream over the given range without copying it: contiguous lvalues are viewed through a std::span,
+    /// other lvalues through std::ranges::ref_view, and rvalues are moved into a std::ranges::owning_view.
+    constexpr auto of(auto&& Value)
     {
-        auto NewView = View | std::views::filter(Func);
-        return StreamImpl<decltype(NewView)>{NewView};
+        using R = decltype(Value);
+
+        if constexpr (std::is_lvalue_reference_v<R> && std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && !std::ranges::view<std::remove_cvref_t<R>>)
+        {
+            return StreamImpl{std::span(Value)};
+        }
+        else if constexpr (std::ranges::viewable_range<R>)
+        {
+            return StreamImpl{std::views::all(std::forward<R>(Value))};
+        }
+        else
+        {
+            return StreamImpl{std::forward<R>(Value)};
+        }
     }
 
-    /// Filters out elements that do not satisfy the provided predicate function.
-    constexpr auto Reject(auto Func)
+    constexpr auto range(auto Begin, auto End)
     {
-        auto NewFunc = [Func](auto Value){ return !Func(Value); };
-        auto NewView = View | std::views::filter(NewFunc);
-        return StreamImpl<decltype(NewView)>{NewView};
+        return StreamImpl{std::views::iota(Begin, End + 1)};
     }
 
-    /// Takes the first 'Count' elements from the view.
-    constexpr auto Take(auto Count)
+    /// Evaluates Func() at compile time, so a table built by a pipeline ending in Collect<N>() is baked into the binary.
+    consteval auto ct(auto Func)
     {
-        auto NewView = View | std::views::take(Count);
-        return StreamImpl<decltype(NewView)>{NewView};
+        return Func();
     }
 
-    /// Splits the view by the given token.
-    constexpr auto SplitBy(auto Token)
+    /// Creates a stream that pops elements from a ring in batches of up to 'BatchSize' until it is closed and drained.
+    template<typename T>
+    auto from(Ring<T>& Source, std::size_t BatchSize = 256)
     {
-        auto NewView = View | std::views::split(Token);
-        return StreamImpl<decltype(NewView)>{NewView};
+        return StreamImpl{Detail::RingView<T>{Source, BatchSize}};
     }
 
-    /// Joins nested ranges into a single range.
-    constexpr auto Join()
+    /// Creates a sink that counts the values pushed into it.
+    constexpr auto counter()
     {
-        auto NewView = View | std::views::join;
-        return StreamImpl<decltype(NewView)>{NewView};
+        return Detail::CounterSink{};
     }
 
-    /// Returns the keys of the view.
-    constexpr auto Keys()
+    /// Creates a sink that writes each value through an output iterator.
+    template<typename It>
+    constexpr auto to(It Out)
     {
-        auto NewView = View | std::views::keys;
-        return StreamImpl<decltype(NewView)>{NewView};
+        return Detail::OutputSink<It>{std::move(Out)};
     }
 
-    /// Returns the values of the view.
-    constexpr auto Values()
+    /// Creates a sink that calls Func(std::span<const T>) for every 'Size' values, and for the remainder on flush.
+    template<typename T>
+    auto batch(std::size_t Size, auto Func)
     {
-        auto NewView = View | std::views::values;
-        return StreamImpl<decltype(NewView)>{NewView};
+        return Detail::BatchSink<T, decltype(Func)>{Size, std::move(Func)};
     }
 
-    /// Checks if all elements satisfy the provided predicate function.
-    constexpr auto All(auto Func)
+    /// Creates a sink that forwards each value to all of the given sinks; std::get<I>(Tee.Sinks) reads them back.
+    template<typename... S>
+    constexpr auto tee(S... Sinks)
     {
-        auto FilteredData = Filter(Func);
-        return Count() == FilteredData.Count();
+        return Detail::TeeSink<S...>{{std::move(Sinks)...}};
     }
 
-    /// Checks if any element satisfies the provided predicate function.
-    constexpr auto Any(auto Func)
+    /// Creates a stream of rows over contiguous columns of equal length (a structure of arrays), each row a
+    /// std::tuple of references into the columns; Project<I...>() narrows it to some of them.
+    template<std::ranges::contiguous_range... C>
+        requires (sizeof...(C) > 0 && (std::ranges::sized_range<C> && ...))
+    auto columns(C&... Columns)
     {
-        auto FilteredData = Filter(Func);
-        return FilteredData.Count() > 0;
+        auto Sizes = std::array<std::size_t, sizeof...(C)>{std::ranges::size(Columns)...};
+        if (std::ranges::adjacent_find(Sizes, std::ranges::not_equal_to{}) != Sizes.end())
+            throw std::invalid_argument("Stream::columns: columns differ in length");
+
+        return StreamImpl{Detail::ColumnsView{std::span(Columns)...}};
     }
 
-    /// Returns unique elements by counting occurrences and filtering out duplicates.
-    constexpr auto Uniq()
+#if STREAM_FILES
+    /// Creates a zero-copy stream over the bytes of a memory-mapped file; View.Span() exposes them as a std::span.
+    inline auto mmap(const std::filesystem::path& Path)
     {
-        return WithIndex()
-            .Map([this](auto ValuePair)
-            {
-                auto [Index, Value] = ValuePair;
-                return std::pair{Take(Index).Count(Value), Value};
-            })
-            .Reject([](auto ValuePair)
-            {
-                auto [Count, Value] = ValuePair;
-                return Count > 0;
-            })
-            .Map([](auto ValuePair)
-            {
-                auto [Count, Value] = ValuePair;
-                return Value;
-            });
+        return StreamImpl{Detail::MappedView{std::make_shared<const Detail::MappedFile>(Path)}};
     }
 
-    /// Pairs each element with its index.
-    constexpr auto WithIndex()
+    /// Creates a stream over a block file written by WriteTo, memory-mapped so uncompressed blocks are read in place;
+    /// throws std::runtime_error if the file doesn't hold T or a block fails its checksum.
+    template<typename T>
+    auto read(const std::filesystem::path& Path)
     {
-        auto Iota = std::views::iota(0, Count());
-        auto NewView = Iota | std::views::transform([this](auto Index)
-        {
-            return std::pair(Index, *std::next(View.begin(), Index));
-        });
-
-        return StreamImpl<decltype(NewView)>{NewView};
+        return StreamImpl{Detail::BlockFileView<T>{std::make_shared<const Detail::MappedFile>(Path)}};
     }
 
-    /// Returns the minimum element in the view.
-    constexpr auto Min()
+    /// Creates a stream of the lines of a memory-mapped file as std::string_view slices, without allocating per line.
+    inline auto lines(const std::filesystem::path& Path)
     {
-        return *std::ranges::min_element(View.begin(), View.end());
+        return StreamImpl{Detail::LinesView{mmap(Path).View}};
     }
+#endif
 
-    /// Returns the maximum element in the view.
-    constexpr auto Max()
+    /// Creates a stream of the lines read from an input stream (e.g. std::cin, or a pipe that can't be mapped).
+    inline auto lines(std::istream& Input)
     {
-        return *std::ranges::max_element(View.begin(), View.end());
+        return StreamImpl{Detail::StreamLinesView{Input}};
     }
 
-    /// Returns the sum of all elements in the view.
-    constexpr auto Sum()
+#if STREAM_FILES
+    /// Creates a stream of blocks read incrementally from a file descriptor, which stays owned by the caller.
+    inline auto bytes(int Descriptor, std::size_t BlockSize = 65536)
     {
-        return std::accumulate(View.begin(), View.end(), 0);
+        return StreamImpl{Detail::BytesView{Descriptor, false, BlockSize}};
     }
 
-    /// Checks if the view contains a specific value.
-    constexpr auto Contains(auto Value)
+    /// Creates a stream of blocks read incrementally from a file.
+    inline auto bytes(const std::filesystem::path& Path, std::size_t BlockSize = 65536)
     {
-        return Count(Value) > 0;
+#if defined(_WIN32)
+        auto Descriptor = ::_wopen(Path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        auto Descriptor = ::open(Path.c_str(), O_RDONLY);
+#endif
+        if (Descriptor < 0)
+            throw std::system_error(errno, std::generic_category(), "Stream::bytes: " + Path.string());
+
+        return StreamImpl{Detail::BytesView{Descriptor, true, BlockSize}};
     }
+#endif
+}
 
-    /// Returns the number of elements in the view.
-    constexpr auto Count()
+namespace Stream
+{
+    namespace Detail
     {
-        return std::ranges::distance(View);
+        /// Resumes 'Target' by symmetric transfer when awaited, or returns to whoever resumed the awaiting coroutine.
+        struct TransferAwaiter
+        {
+            std::coroutine_handle<> Target{};
+
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept { return Target ? Target : std::noop_coroutine(); }
+            void await_resume() const noexcept {}
+        };
+
+        /// Returns the awaiter co_await would use for the value: its operator co_await() result, or the value itself.
+        template<typename A>
+        decltype(auto) GetAwaiter(A&& Value)
+        {
+            if constexpr (requires { std::forward<A>(Value).operator co_await(); })
+                return std::forward<A>(Value).operator co_await();
+            else
+                return std::forward<A>(Value);
+        }
+
+        /// Types that can be co_awaited, such as Task or an awaiter.
+        template<typename A>
+        concept Awaitable = requires(A&& Value) { GetAwaiter(std::forward<A>(Value)).await_ready(); };
+
+        template<typename A>
+        using AwaitResult = decltype(GetAwaiter(std::declval<A>()).await_resume());
+
+        /// The value a stage function produces: the awaited result when it returns an awaitable, its result otherwise.
+        template<typename R>
+        struct Awaited { using Type = R; };
+
+        template<Awaitable R>
+        struct Awaited<R> { using Type = AwaitResult<R>; };
+
+        /// Stores the value or exception a Task completes with.
+        template<typename T>
+        class TaskResult
+        {
+        public:
+            void return_value(T Value) { Result.template emplace<1>(std::move(Value)); }
+            void unhandled_exception() { Result.template emplace<2>(std::current_exception()); }
+
+            T Take()
+            {
+                if (Result.index() == 2)
+                    std::rethrow_exception(std::get<2>(Result));
+
+                return std::move(std::get<1>(Result));
+            }
+
+        private:
+            std::variant<std::monostate, T, std::exception_ptr> Result{};
+        };
+
+        template<>
+        class TaskResult<void>
+        {
+        public:
+            void return_void() {}
+            void unhandled_exception() { Error = std::current_exception(); }
+
+            void Take()
+            {
+                if (Error)
+                    std::rethrow_exception(Error);
+            }
+
+        private:
+            std::exception_ptr Error{};
+        };
+
+        /// Coroutine type that starts eagerly and destroys itself on completion.
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
     }
 
-    /// Counts the occurrences of a specific value in the view.
-    constexpr auto Count(auto Value)
+    /// A lazily started coroutine producing a T: co_await it from another coroutine, or block on it with SyncWait.
+    template<typename T = void>
+    class [[nodiscard]] Task
     {
-        return std::ranges::count(View, Value);
-    }
+    public:
+        struct promise_type : Detail::TaskResult<T>
+        {
+            std::coroutine_handle<> Continuation{};
+
+            Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            Detail::TransferAwaiter final_suspend() noexcept { return {Continuation}; }
+        };
+
+        Task(Task&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+        Task& operator=(Task&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                if (Handle)
+                    Handle.destroy();
+                Handle = std::exchange(Other.Handle, {});
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (Handle)
+                Handle.destroy();
+        }
+
+        auto operator co_await() noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> Handle;
+
+                bool await_ready() const noexcept { return Handle.done(); }
 
-    /// Chunks the view into sub ranges of a given size.
-    constexpr auto ChunkEvery(auto Count)
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+                {
+                    Handle.promise().Continuation = Awaiting;
+                    return Handle;
+                }
+
+                T await_resume() { return Handle.promise().Take(); }
+            };
+            return Awaiter{Handle};
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> Handle) : Handle(Handle) {}
+
+        std::coroutine_handle<promise_type> Handle{};
+    };
+
+    /// A coroutine that may co_await between the values it co_yields; consumers pull each one with co_await Next().
+    template<typename T>
+    class [[nodiscard]] AsyncGenerator
     {
-        // TODO: Replace with std::views::chunk when used with C++23
-        auto Iota = std::views::iota(0, (std::ranges::distance(View) + Count - 1) / Count);
-        auto NewView = Iota | std::views::transform([this, Count](auto Index)
+    public:
+        struct promise_type
         {
-            auto Begin = std::next(View.begin(), Index * Count);
-            auto End = std::next(Begin, std::min(static_cast<size_t>(Count), static_cast<size_t>(std::ranges::distance(Begin, View.end()))));
-            
-            return std::ranges::subrange(Begin, End);
-        });
+            std::optional<T> Current{};
+            std::coroutine_handle<> Consumer{};
+            std::exception_ptr Error{};
+
+            AsyncGenerator get_return_object() { return AsyncGenerator{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            Detail::TransferAwaiter final_suspend() noexcept { return {Consumer}; }
+
+            Detail::TransferAwaiter yield_value(T Value)
+            {
+                Current.emplace(std::move(Value));
+                return {Consumer};
+            }
+
+            void return_void() {}
+            void unhandled_exception() { Error = std::current_exception(); }
+        };
+
+        AsyncGenerator(AsyncGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+        AsyncGenerator& operator=(AsyncGenerator&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                if (Handle)
+                    Handle.destroy();
+                Handle = std::exchange(Other.Handle, {});
+            }
+            return *this;
+        }
+
+        ~AsyncGenerator()
+        {
+            if (Handle)
+                Handle.destroy();
+        }
+
+        /// Resumes the producer until its next value; the awaited result is std::nullopt once it has finished.
+        auto Next()
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> Handle;
+
+                bool await_ready() const noexcept { return !Handle || Handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+                {
+                    Handle.promise().Consumer = Awaiting;
+                    Handle.promise().Current.reset();
+                    return Handle;
+                }
+
+                std::optional<T> await_resume()
+                {
+                    if (!Handle)
+                        return std::nullopt;
+
+                    auto& Promise = Handle.promise();
+                    if (Promise.Error)
+                        std::rethrow_exception(std::exchange(Promise.Error, {}));
+
+                    return std::exchange(Promise.Current, std::nullopt);
+                }
+            };
+            return Awaiter{Handle};
+        }
+
+    private:
+        explicit AsyncGenerator(std::coroutine_handle<promise_type> Handle) : Handle(Handle) {}
+
+        std::coroutine_handle<promise_type> Handle{};
+    };
+
+    /// A bounded, thread-safe queue between coroutines: Send suspends while it is full and Receive while it is empty,
+    /// so a slow consumer holds back its producer. Suspended waiters are resumed on the thread that unblocks them.
+    template<typename T>
+    class Channel
+    {
+        struct SendAwaiter
+        {
+            Channel* Owner;
+            T Value;
+            std::coroutine_handle<> Handle{};
+            bool Sent = false;
 
-        return StreamImpl<decltype(NewView)>{NewView};
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> Awaiting)
+            {
+                Handle = Awaiting;
+
+                auto Lock = std::unique_lock{Owner->Mutex};
+                if (Owner->Closed)
+                    return false;
+
+                // A waiting receiver means the buffer is empty, so the value goes straight to it
+                if (!Owner->Receivers.empty())
+                {
+                    auto* Receiver = Owner->Receivers.front();
+                    Owner->Receivers.pop_front();
+                    Receiver->Result.emplace(std::move(Value));
+                    Sent = true;
+
+                    Lock.unlock();
+                    Receiver->Handle.resume();
+                    return false;
+                }
+
+                if (Owner->Buffer.size() < Owner->Capacity)
+                {
+                    Owner->Buffer.push_back(std::move(Value));
+                    Sent = true;
+                    return false;
+                }
+
+                Owner->Senders.push_back(this);
+                return true;
+            }
+
+            bool await_resume() const noexcept { return Sent; }
+        };
+
+        struct ReceiveAwaiter
+        {
+            Channel* Owner;
+            std::coroutine_handle<> Handle{};
+            std::optional<T> Result{};
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> Awaiting)
+            {
+                Handle = Awaiting;
+
+                auto Lock = std::unique_lock{Owner->Mutex};
+                SendAwaiter* Sender = nullptr;
+                if (!Owner->Buffer.empty())
+                {
+                    Result.emplace(std::move(Owner->Buffer.front()));
+                    Owner->Buffer.pop_front();
+
+                    // Room was just made, so the first blocked sender can move its value into the buffer
+                    if (!Owner->Senders.empty())
+                    {
+                        Sender = Owner->Senders.front();
+                        Owner->Senders.pop_front();
+                        Owner->Buffer.push_back(std::move(Sender->Value));
+                        Sender->Sent = true;
+                    }
+                }
+                else if (!Owner->Senders.empty())
+                {
+                    Sender = Owner->Senders.front();
+                    Owner->Senders.pop_front();
+                    Result.emplace(std::move(Sender->Value));
+                    Sender->Sent = true;
+                }
+                else if (!Owner->Closed)
+                {
+                    Owner->Receivers.push_back(this);
+                    return true;
+                }
+
+                Lock.unlock();
+                if (Sender)
+                    Sender->Handle.resume();
+
+                return false;
+            }
+
+            std::optional<T> await_resume() { return std::move(Result); }
+        };
+
+    public:
+        /// Creates a channel buffering up to 'Capacity' values; with 0 every Send waits for a matching Receive.
+        explicit Channel(std::size_t Capacity) : Capacity(Capacity) {}
+
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        /// Awaits room for the value; the awaited result is false if the channel was closed and the value dropped.
+        SendAwaiter Send(T Value) { return SendAwaiter{this, std::move(Value)}; }
+
+        /// Awaits the next value; the awaited result is std::nullopt once the channel is closed and drained.
+        ReceiveAwaiter Receive() { return ReceiveAwaiter{this}; }
+
+        /// Closes the channel: pending and later sends fail, and receivers drain what is already buffered.
+        void Close()
+        {
+            auto WokenSenders = std::deque<SendAwaiter*>{};
+            auto WokenReceivers = std::deque<ReceiveAwaiter*>{};
+            {
+                auto Lock = std::scoped_lock{Mutex};
+                Closed = true;
+                WokenSenders.swap(Senders);
+                WokenReceivers.swap(Receivers);
+            }
+
+            for (auto* Sender : WokenSenders)
+                Sender->Handle.resume();
+            for (auto* Receiver : WokenReceivers)
+                Receiver->Handle.resume();
+        }
+
+    private:
+        std::mutex Mutex{};
+        std::deque<T> Buffer{};
+        std::deque<SendAwaiter*> Senders{};
+        std::deque<ReceiveAwaiter*> Receivers{};
+        std::size_t Capacity = 0;
+        bool Closed = false;
+    };
+
+    /// Blocks the calling thread until the awaitable (e.g. a Task) completes, returning its result or rethrowing its exception.
+    template<typename A>
+    auto SyncWait(A&& Awaitable) -> std::remove_cvref_t<Detail::AwaitResult<A>>
+    {
+        using ResultType = std::remove_cvref_t<Detail::AwaitResult<A>>;
+
+        struct Completion
+        {
+            std::mutex Mutex{};
+            std::condition_variable Signal{};
+            bool Done = false;
+        };
+
+        // Shared with the coroutine frame, so a thread completing the task can still signal and unlock after the
+        // waiter wakes up and returns
+        auto Sync = std::make_shared<Completion>();
+        auto Error = std::exception_ptr{};
+        auto Result = std::optional<std::conditional_t<std::is_void_v<ResultType>, std::monostate, ResultType>>{};
+
+        // Kept in a named variable because the coroutine frame refers to the lambda's captures until it completes
+        auto Driver = [&](std::shared_ptr<Completion> Shared) -> Detail::DetachedTask
+        {
+            try
+            {
+                if constexpr (std::is_void_v<ResultType>)
+                {
+                    co_await std::forward<A>(Awaitable);
+                    Result.emplace();
+                }
+                else
+                {
+                    Result.emplace(co_await std::forward<A>(Awaitable));
+                }
+            }
+            catch (...)
+            {
+                Error = std::current_exception();
+            }
+
+            auto Lock = std::scoped_lock{Shared->Mutex};
+            Shared->Done = true;
+            Shared->Signal.notify_one();
+        };
+        Driver(Sync);
+
+        auto Lock = std::unique_lock{Sync->Mutex};
+        Sync->Signal.wait(Lock, [&Sync]{ return Sync->Done; });
+
+        if (Error)
+            std::rethrow_exception(Error);
+
+        if constexpr (!std::is_void_v<ResultType>)
+            return std::move(*Result);
     }
 
-    /// Collects the view elements into a std::vector.
-    auto Collect()
+    namespace Detail
     {
-        std::vector<std::ranges::range_value_t<T>> Result;
-    
-        // Reserve space if the view size is known (e.g., random access or sized ranges)
-        if constexpr (std::ranges::sized_range<T>)
+        template<typename U, typename T, typename F>
+        AsyncGenerator<U> MapStage(AsyncGenerator<T> Source, F Func)
         {
-            Result.reserve(std::ranges::distance(View));
+            while (auto Value = co_await Source.Next())
+            {
+                if constexpr (Awaitable<std::invoke_result_t<F&, T>>)
+                    co_yield co_await std::invoke(Func, std::move(*Value));
+                else
+                    co_yield std::invoke(Func, std::move(*Value));
+            }
+        }
+
+        template<typename T, typename F>
+        AsyncGenerator<T> EachStage(AsyncGenerator<T> Source, F Func)
+        {
+            while (auto Value = co_await Source.Next())
+            {
+                if constexpr (Awaitable<std::invoke_result_t<F&, const T&>>)
+                    co_await std::invoke(Func, std::as_const(*Value));
+                else
+                    std::invoke(Func, std::as_const(*Value));
+
+                co_yield std::move(*Value);
+            }
+        }
+
+        template<typename T, typename F>
+        AsyncGenerator<T> FilterStage(AsyncGenerator<T> Source, F Func, bool Keep)
+        {
+            while (auto Value = co_await Source.Next())
+            {
+                auto Matches = false;
+                if constexpr (Awaitable<std::invoke_result_t<F&, const T&>>)
+                    Matches = static_cast<bool>(co_await std::invoke(Func, std::as_const(*Value)));
+                else
+                    Matches = static_cast<bool>(std::invoke(Func, std::as_const(*Value)));
+
+                if (Matches == Keep)
+                    co_yield std::move(*Value);
+            }
+        }
+
+        template<typename T>
+        AsyncGenerator<T> TakeStage(AsyncGenerator<T> Source, std::size_t Count)
+        {
+            while (Count)
+            {
+                auto Value = co_await Source.Next();
+                if (!Value)
+                    break;
+
+                --Count;
+                co_yield std::move(*Value);
+            }
+        }
+
+        template<typename T, typename Acc, typename F>
+        Task<Acc> ReduceTask(AsyncGenerator<T> Source, Acc Result, F Func)
+        {
+            while (auto Value = co_await Source.Next())
+                Result = std::invoke(Func, std::move(Result), std::move(*Value));
+
+            co_return Result;
+        }
+
+        template<typename T, typename S>
+        Task<S> ForEachTask(AsyncGenerator<T> Source, S Sink)
+        {
+            while (auto Value = co_await Source.Next())
+            {
+                if (!Emit(Sink, std::move(*Value)))
+                    break;
+            }
+
+            Flush(Sink);
+            co_return Sink;
+        }
+
+        template<typename T>
+        Task<> IntoTask(AsyncGenerator<T> Source, Channel<T>& Target)
+        {
+            while (auto Value = co_await Source.Next())
+            {
+                if (!co_await Target.Send(std::move(*Value)))
+                    break;
+            }
+
+            Target.Close();
+        }
+
+        template<typename T>
+        Task<> RunTask(AsyncGenerator<T> Source)
+        {
+            // Bound to a variable: GCC 12 miscompiles a bare co_await used as a loop condition
+            while (auto Value = co_await Source.Next())
+            {
+            }
+        }
+
+        template<typename V>
+        AsyncGenerator<std::ranges::range_value_t<V>> RangeSource(V Range)
+        {
+            for (auto&& Value : Range)
+                co_yield std::forward<decltype(Value)>(Value);
+        }
+
+        template<typename T>
+        AsyncGenerator<T> ChannelSource(Channel<T>& Source)
+        {
+            while (auto Value = co_await Source.Receive())
+                co_yield std::move(*Value);
         }
-        
-        std::ranges::copy(View, std::back_inserter(Result));
-        return Result;
     }
 
-    /// Runs the stream operations.
-    auto Run()
+    /// An asynchronous pipeline over an AsyncGenerator with StreamImpl's method names. Map, Each and Filter functions
+    /// may return an awaitable (e.g. a Task) to suspend the pipeline, and terminals return a Task to co_await or SyncWait.
+    template<typename T>
+    struct AsyncStream
+    {
+        Stream::AsyncGenerator<T> Source;
+
+        /// Transforms each element using the provided function, awaiting its result when it is awaitable.
+        auto Map(auto Func)
+        {
+            using ValueType = std::remove_cvref_t<typename Detail::Awaited<std::invoke_result_t<decltype(Func)&, T>>::Type>;
+            return AsyncStream<ValueType>{Detail::MapStage<ValueType>(std::move(Source), std::move(Func))};
+        }
+
+        /// Applies a function to each element but passes the original value on.
+        auto Each(auto Func)
+        {
+            return AsyncStream<T>{Detail::EachStage(std::move(Source), std::move(Func))};
+        }
+
+        /// Keeps only the elements that satisfy the provided predicate.
+        auto Filter(auto Func)
+        {
+            return AsyncStream<T>{Detail::FilterStage(std::move(Source), std::move(Func), true)};
+        }
+
+        /// Filters out the elements that satisfy the provided predicate.
+        auto Reject(auto Func)
+        {
+            return AsyncStream<T>{Detail::FilterStage(std::move(Source), std::move(Func), false)};
+        }
+
+        /// Takes the first 'Count' elements, without pulling any further ones from the source.
+        auto Take(std::size_t Count)
+        {
+            return AsyncStream<T>{Detail::TakeStage(std::move(Source), Count)};
+        }
+
+        /// Reduces the stream to a single value using the provided function.
+        auto Reduce(auto InitialValue, auto Func)
+        {
+            return Detail::ReduceTask(std::move(Source), std::move(InitialValue), std::move(Func));
+        }
+
+        /// Collects the elements into a std::vector.
+        auto Collect()
+        {
+            return Reduce(std::vector<T>{}, [](std::vector<T> Result, T Value)
+            {
+                Result.push_back(std::move(Value));
+                return Result;
+            });
+        }
+
+        /// Counts the elements.
+        auto Count()
+        {
+            return Reduce(std::size_t{0}, [](std::size_t Result, const T&){ return Result + 1; });
+        }
+
+        /// Pushes every element into a sink like StreamImpl::ForEach and completes with the sink.
+        auto ForEach(auto Sink)
+        {
+            return Detail::ForEachTask(std::move(Source), std::move(Sink));
+        }
+
+        /// Sends every element into a channel, waiting while it is full, and closes it once the stream ends.
+        Task<> Into(Stream::Channel<T>& Target)
+        {
+            return Detail::IntoTask(std::move(Source), Target);
+        }
+
+        /// Runs the stream for its side effects.
+        Task<> Run()
+        {
+            return Detail::RunTask(std::move(Source));
+        }
+    };
+
+    /// Creates an asynchronous stream from a coroutine that co_yields values.
+    template<typename T>
+    auto async(AsyncGenerator<T> Source)
     {
-        Collect();
+        return AsyncStream<T>{std::move(Source)};
     }
-};
 
-namespace Stream
-{
-    static constexpr auto of(auto Value)
+    /// Creates an asynchronous stream that receives from a channel until it is closed and drained.
+    template<typename T>
+    auto async(Channel<T>& Source)
     {
-        return StreamImpl{Value};
+        return AsyncStream<T>{Detail::ChannelSource(Source)};
     }
 
-    static constexpr auto range(auto Begin, auto End)
+    /// Creates an asynchronous stream over the elements of a synchronous one.
+    template<typename V>
+    auto async(StreamImpl<V> Source)
     {
-        return StreamImpl{std::views::iota(Begin, End + 1)};
+        return async(Detail::RangeSource(std::move(Source.View)));
     }
 }
+
+#if defined(STREAM_PROFILE_ALLOCATIONS)
+// Replacement global allocation functions feeding Profiler::CountAllocation; define STREAM_PROFILE_ALLOCATIONS
+// in exactly one translation unit. They count with or without STREAM_PROFILE, so tests can read ThreadAllocations.
+void* operator new(std::size_t Size)
+{
+    Stream::Profiler::CountAllocation();
+    if (auto* Memory = std::malloc(Size ? Size : 1))
+        return Memory;
+
+    throw std::bad_alloc{};
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC inlines these into its containers and then reports the malloc/free pairing as a new/free mismatch
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* Memory) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { std::free(Memory); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
@@ -0,0 +1,997 @@
+#include <benchmark/benchmark.h>
+#include <list>
+#include <unordered_set>
+#include "stream.h"
+
+// Each operation is measured against the hand-written loop (or std::ranges code) it replaces,
+// over vector, list and iota sources from 1e2 to 1e7 elements.
+
+namespace
+{
+    struct VectorSource
+    {
+        std::vector<int> Data;
+
+        explicit VectorSource(int Size) : Data(Stream::range(0, Size - 1).Map([](int Value){ return Value % 1000; }).Collect()) {}
+        auto Pipeline() { return Stream::of(Data); }
+        auto& Raw() { return Data; }
+    };
+
+    struct ListSource
+    {
+        std::list<int> Data;
+
+        explicit ListSource(int Size)
+        {
+            for (auto Value = 0; Value < Size; ++Value)
+                Data.push_back(Value % 1000);
+        }
+
+        auto Pipeline() { return Stream::of(Data); }
+        auto& Raw() { return Data; }
+    };
+
+    struct IotaSource
+    {
+        int Size;
+
+        explicit IotaSource(int Size) : Size(Size) {}
+        auto Pipeline() { return Stream::range(0, Size - 1); }
+        auto Raw() { return std::views::iota(0, Size); }
+    };
+
+    template<typename Source>
+    void MapChainStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Map([](int Value){ return Value * 3; })
+                .Map([](int Value){ return Value + 1; })
+                .Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void MapChainLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (auto Value : Input.Raw())
+                Result += Value * 3 + 1;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void FilterStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Filter([](int Value){ return Value % 2 == 0; })
+                .Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void FilterLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ptrdiff_t{0};
+            for (auto Value : Input.Raw())
+                Result += Value % 2 == 0;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void FilterMapStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Filter([](int Value){ return Value % 2 == 0; })
+                .Map([](int Value){ return Value * 3; })
+                .Filter([](int Value){ return Value % 5 != 0; })
+                .Reduce(std::int64_t{0}, std::plus{})
+                .Collect();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void FilterMapFused(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Fuse()
+                .Filter([](int Value){ return Value % 2 == 0; })
+                .Map([](int Value){ return Value * 3; })
+                .Filter([](int Value){ return Value % 5 != 0; })
+                .Reduce(std::int64_t{0}, std::plus{})
+                .Collect();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void FilterMapLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (auto Value : Input.Raw())
+            {
+                if (Value % 2 == 0 && Value * 3 % 5 != 0)
+                    Result += Value * 3;
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void UniqStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Uniq().Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void UniqLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Seen = std::unordered_set<int>{};
+            for (auto Value : Input.Raw())
+                Seen.insert(Value);
+            benchmark::DoNotOptimize(Seen.size());
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void WithIndexStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Filter([](int Value){ return Value % 2 == 0; })
+                .WithIndex()
+                .Reduce(std::int64_t{0}, [](std::int64_t Acc, auto Pair){ return Acc + Pair.first * Pair.second; })
+                .Collect();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void WithIndexLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            auto Index = std::int64_t{0};
+            for (auto Value : Input.Raw())
+            {
+                if (Value % 2 == 0)
+                    Result += Index++ * Value;
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ChunkEveryStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .ChunkEvery(64)
+                .Map([](auto Chunk){ return *Chunk.begin(); })
+                .Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ChunkEveryLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            auto Index = 0;
+            for (auto Value : Input.Raw())
+            {
+                if (Index++ % 64 == 0)
+                    Result += Value;
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void CollectStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Collect();
+            benchmark::DoNotOptimize(Result.data());
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void CollectLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::vector<int>{};
+            std::ranges::copy(Input.Raw(), std::back_inserter(Result));
+            benchmark::DoNotOptimize(Result.data());
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ReduceStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Reduce(std::int64_t{0}, [](std::int64_t Acc, int Value){ return Acc ^ (Acc + Value); })
+                .Collect();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ReduceLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::accumulate(Input.Raw().begin(), Input.Raw().end(), std::int64_t{0}, [](std::int64_t Acc, int Value){ return Acc ^ (Acc + Value); });
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void StatsStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Stats();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void StatsLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Min = std::ranges::min(Input.Raw());
+            auto Max = std::ranges::max(Input.Raw());
+            auto Sum = std::accumulate(Input.Raw().begin(), Input.Raw().end(), std::int64_t{0});
+            benchmark::DoNotOptimize(Min);
+            benchmark::DoNotOptimize(Max);
+            benchmark::DoNotOptimize(Sum);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void TopKStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().TopK(100);
+            benchmark::DoNotOptimize(Result.data());
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void TopKLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::vector<int>{};
+            std::ranges::copy(Input.Raw(), std::back_inserter(Result));
+            std::sort(Result.begin(), Result.end(), std::greater{});
+            Result.resize(std::min<std::size_t>(Result.size(), 100));
+            benchmark::DoNotOptimize(Result.data());
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void AnyStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Any([](int Value){ return Value < 0; });
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void AnyLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ranges::any_of(Input.Raw(), [](int Value){ return Value < 0; });
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void RejectStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Reject([](int Value){ return Value % 3 == 0; })
+                .Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void RejectLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ptrdiff_t{0};
+            for (auto Value : Input.Raw())
+                Result += Value % 3 != 0;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void TakeStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Take(State.range(0) / 2)
+                .Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0) / 2);
+    }
+
+    template<typename Source>
+    void TakeLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            auto Left = State.range(0) / 2;
+            for (auto Value : Input.Raw())
+            {
+                if (Left-- == 0)
+                    break;
+                Result += Value;
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0) / 2);
+    }
+
+    template<typename Source>
+    void SplitByStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .SplitBy(0)
+                .Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void SplitByLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ptrdiff_t{0};
+            auto Open = false;
+            for (auto Value : Input.Raw())
+            {
+                if (Value == 0)
+                {
+                    ++Result;
+                    Open = false;
+                }
+                else
+                    Open = true;
+            }
+            Result += Open;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void JoinStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline()
+                .Map([](int Value){ return std::array{Value, Value + 1}; })
+                .Join()
+                .Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void JoinLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (auto Value : Input.Raw())
+                Result += Value + (Value + 1);
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void MinStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Min();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void MinLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ranges::min(Input.Raw());
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void MaxStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Max();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void MaxLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ranges::max(Input.Raw());
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void SumStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void SumLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::accumulate(Input.Raw().begin(), Input.Raw().end(), std::int64_t{0});
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void CountStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Count(7);
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void CountLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ranges::count(Input.Raw(), 7);
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ContainsStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Input.Pipeline().Contains(-1);
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void ContainsLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::ranges::find(Input.Raw(), -1) != std::ranges::end(Input.Raw());
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void EachStream(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            Input.Pipeline()
+                .Each([&Result](int Value){ Result += Value; })
+                .Run();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    template<typename Source>
+    void EachLoop(benchmark::State& State)
+    {
+        auto Input = Source(static_cast<int>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (auto Value : Input.Raw())
+                Result += Value;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Splitting text on a byte: the memchr-backed SplitBy versus a std::string_view::find loop
+    std::string Lines(std::size_t Size)
+    {
+        auto Text = std::string{};
+        for (auto Index = std::size_t{0}; Text.size() < Size; ++Index)
+            Text.append(Index % 80, 'x').push_back('\n');
+        return Text;
+    }
+
+    void SplitByCharStream(benchmark::State& State)
+    {
+        auto Text = Lines(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Text).SplitBy('\n').Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetBytesProcessed(State.iterations() * State.range(0));
+    }
+
+    void SplitByCharLoop(benchmark::State& State)
+    {
+        auto Text = Lines(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto View = std::string_view(Text);
+            auto Result = std::ptrdiff_t{0};
+            for (auto Start = std::size_t{0}; Start <= View.size(); ++Result)
+            {
+                auto End = View.find('\n', Start);
+                Start = End == std::string_view::npos ? View.size() + 1 : End + 1;
+            }
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetBytesProcessed(State.iterations() * State.range(0));
+    }
+
+    // Projecting one side of key/value pairs
+    std::vector<std::pair<int, int>> Pairs(std::size_t Size)
+    {
+        return Stream::range(std::size_t{0}, Size - 1).Map([](std::size_t Index){ return std::pair{static_cast<int>(Index % 1000), static_cast<int>(Index % 7)}; }).Collect();
+    }
+
+    void KeysStream(benchmark::State& State)
+    {
+        auto Input = Pairs(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Input).Keys().Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void ValuesStream(benchmark::State& State)
+    {
+        auto Input = Pairs(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Input).Values().Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void KeysLoop(benchmark::State& State)
+    {
+        auto Input = Pairs(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (const auto& [Key, Value] : Input)
+                Result += Key;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void ValuesLoop(benchmark::State& State)
+    {
+        auto Input = Pairs(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = std::int64_t{0};
+            for (const auto& [Key, Value] : Input)
+                Result += Value;
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // A wide record, where summing one field drags the other 15 through the cache
+    struct Record
+    {
+        std::int64_t Fields[16];
+    };
+
+    void RecordFieldSum(benchmark::State& State)
+    {
+        auto Records = std::vector<Record>(static_cast<std::size_t>(State.range(0)), Record{{1, 2, 3}});
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Records).Map([](const Record& Value){ return Value.Fields[2]; }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void ColumnFieldSum(benchmark::State& State)
+    {
+        auto Size = static_cast<std::size_t>(State.range(0));
+        auto First = std::vector<std::int64_t>(Size, 1);
+        auto Second = std::vector<std::int64_t>(Size, 2);
+        auto Third = std::vector<std::int64_t>(Size, 3);
+        for (auto _ : State)
+        {
+            auto Result = Stream::columns(First, Second, Third).Project<2>().Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Scrambled values in [0, 100), so a 'Value < 50' predicate is taken at random half the time
+    std::vector<int> Scrambled(std::size_t Size)
+    {
+        return Stream::range(std::size_t{0}, Size - 1).Map([](std::size_t Index){ return static_cast<int>(Index * 2654435761u >> 7) % 100; }).Collect();
+    }
+
+    void FilterHalfStream(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Values).Filter([](int Value){ return Value < 50; }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void FilterHalfBatch(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Values).FilterBatch([](int Value){ return Value < 50; }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Combining two columns element-wise, lazily versus collecting both streams first
+    void ZipWithStream(benchmark::State& State)
+    {
+        auto Size = static_cast<int>(State.range(0));
+        for (auto _ : State)
+        {
+            auto Result = Stream::range(0, Size - 1).ZipWith([](int Left, int Right){ return std::int64_t{Left} * Right; }, Stream::range(1, Size)).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void ZipWithCollected(benchmark::State& State)
+    {
+        auto Size = static_cast<int>(State.range(0));
+        for (auto _ : State)
+        {
+            auto Left = Stream::range(0, Size - 1).Collect();
+            auto Right = Stream::range(1, Size).Collect();
+            auto Result = std::int64_t{0};
+            for (std::size_t Index = 0; Index < Left.size(); ++Index)
+                Result += std::int64_t{Left[Index]} * Right[Index];
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Rolling maximum over a 1000-element window: two-stack sliding reduction versus refolding each window
+    void SlidingMaxStream(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Values).Sliding(1000, [](int A, int B){ return std::max(A, B); }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void SlidingMaxWindow(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Values).Window(1000).Map([](auto Window){ return std::ranges::max(Window); }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // The same filter/map pipeline behind a type-erased AnyStream, which dispatches once per batch
+    void ErasedStream(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Erased = Stream::of(Values).Map([](int Value){ return Value * 3; }).Erase();
+            auto Result = Erased.Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void ErasedBaseline(benchmark::State& State)
+    {
+        auto Values = Scrambled(static_cast<std::size_t>(State.range(0)));
+        for (auto _ : State)
+        {
+            auto Result = Stream::of(Values).Map([](int Value){ return Value * 3; }).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Cardinality of a stream of mostly distinct values: a 4 KB HyperLogLog versus an exact hash set
+    void CountDistinctSketch(benchmark::State& State)
+    {
+        auto Size = static_cast<int>(State.range(0));
+        for (auto _ : State)
+        {
+            auto Result = Stream::range(0, Size - 1).Map([](int Value){ return Value / 2; }).ApproxCountDistinct();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    void CountDistinctExact(benchmark::State& State)
+    {
+        auto Size = static_cast<int>(State.range(0));
+        for (auto _ : State)
+        {
+            auto Result = Stream::range(0, Size - 1).Map([](int Value){ return Value / 2; }).Uniq().Count();
+            benchmark::DoNotOptimize(Result);
+        }
+        State.SetItemsProcessed(State.iterations() * State.range(0));
+    }
+
+    // Spilling a stream to a block file and mapping it back
+    void BlockFileWrite(benchmark::State& State)
+    {
+        auto Path = std::filesystem::temp_directory_path() / "stream_bench_blocks.bin";
+        auto Size = static_cast<std::int64_t>(State.range(0));
+        for (auto _ : State)
+        {
+            auto Result = Stream::range(std::int64_t{0}, Size - 1).WriteTo(Path);
+            benchmark::DoNotOptimize(Result);
+        }
+        std::filesystem::remove(Path);
+        State.SetBytesProcessed(State.iterations() * State.range(0) * 8);
+    }
+
+    void BlockFileRead(benchmark::State& State)
+    {
+        auto Path = std::filesystem::temp_directory_path() / "stream_bench_blocks.bin";
+        Stream::range(std::int64_t{0}, State.range(0) - 1).WriteTo(Path);
+        for (auto _ : State)
+        {
+            auto Result = Stream::read<std::int64_t>(Path).Sum();
+            benchmark::DoNotOptimize(Result);
+        }
+        std::filesystem::remove(Path);
+        State.SetBytesProcessed(State.iterations() * State.range(0) * 8);
+    }
+}
+
+#define STREAM_BENCHMARK(Name) \
+    BENCHMARK_TEMPLATE(Name, VectorSource)->RangeMultiplier(10)->Range(100, 10'000'000); \
+    BENCHMARK_TEMPLATE(Name, ListSource)->RangeMultiplier(10)->Range(100, 10'000'000); \
+    BENCHMARK_TEMPLATE(Name, IotaSource)->RangeMultiplier(10)->Range(100, 10'000'000)
+
+STREAM_BENCHMARK(MapChainStream);
+STREAM_BENCHMARK(MapChainLoop);
+STREAM_BENCHMARK(FilterStream);
+STREAM_BENCHMARK(FilterLoop);
+STREAM_BENCHMARK(FilterMapStream);
+STREAM_BENCHMARK(FilterMapFused);
+STREAM_BENCHMARK(FilterMapLoop);
+STREAM_BENCHMARK(UniqStream);
+STREAM_BENCHMARK(UniqLoop);
+STREAM_BENCHMARK(WithIndexStream);
+STREAM_BENCHMARK(WithIndexLoop);
+STREAM_BENCHMARK(ChunkEveryStream);
+STREAM_BENCHMARK(ChunkEveryLoop);
+STREAM_BENCHMARK(CollectStream);
+STREAM_BENCHMARK(CollectLoop);
+STREAM_BENCHMARK(ReduceStream);
+STREAM_BENCHMARK(ReduceLoop);
+STREAM_BENCHMARK(StatsStream);
+STREAM_BENCHMARK(StatsLoop);
+STREAM_BENCHMARK(TopKStream);
+STREAM_BENCHMARK(TopKLoop);
+STREAM_BENCHMARK(AnyStream);
+STREAM_BENCHMARK(AnyLoop);
+STREAM_BENCHMARK(RejectStream);
+STREAM_BENCHMARK(RejectLoop);
+STREAM_BENCHMARK(TakeStream);
+STREAM_BENCHMARK(TakeLoop);
+STREAM_BENCHMARK(SplitByStream);
+STREAM_BENCHMARK(SplitByLoop);
+STREAM_BENCHMARK(JoinStream);
+STREAM_BENCHMARK(JoinLoop);
+STREAM_BENCHMARK(MinStream);
+STREAM_BENCHMARK(MinLoop);
+STREAM_BENCHMARK(MaxStream);
+STREAM_BENCHMARK(MaxLoop);
+STREAM_BENCHMARK(SumStream);
+STREAM_BENCHMARK(SumLoop);
+STREAM_BENCHMARK(CountStream);
+STREAM_BENCHMARK(CountLoop);
+STREAM_BENCHMARK(ContainsStream);
+STREAM_BENCHMARK(ContainsLoop);
+STREAM_BENCHMARK(EachStream);
+STREAM_BENCHMARK(EachLoop);
+
+BENCHMARK(RecordFieldSum)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ColumnFieldSum)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(FilterHalfStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(FilterHalfBatch)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ZipWithStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ZipWithCollected)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(SlidingMaxStream)->RangeMultiplier(10)->Range(10'000, 1'000'000);
+BENCHMARK(SlidingMaxWindow)->RangeMultiplier(10)->Range(10'000, 1'000'000);
+BENCHMARK(ErasedStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ErasedBaseline)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(CountDistinctSketch)->RangeMultiplier(10)->Range(1000, 10'000'000);
+BENCHMARK(CountDistinctExact)->RangeMultiplier(10)->Range(1000, 10'000'000);
+BENCHMARK(BlockFileWrite)->RangeMultiplier(10)->Range(1000, 10'000'000);
+BENCHMARK(BlockFileRead)->RangeMultiplier(10)->Range(1000, 10'000'000);
+BENCHMARK(SplitByCharStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(SplitByCharLoop)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(KeysStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(KeysLoop)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ValuesStream)->RangeMultiplier(10)->Range(100, 10'000'000);
+BENCHMARK(ValuesLoop)->RangeMultiplier(10)->Range(100, 10'000'000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,266 @@
+// Allocation and complexity guards: every test counts what a pipeline allocates or how much work it does,
+// so quadratic rescans and hidden copies fail here instead of showing up in production profiles.
+#define STREAM_PROFILE_ALLOCATIONS
+#include <gtest/gtest.h>
+#include <cmath>
+#include <list>
+#include <random>
+#include <string>
+#include "stream.h"
+
+namespace
+{
+    /// Number of global operator new calls Func makes on the calling thread.
+    std::uint64_t AllocationsOf(auto&& Func)
+    {
+        const auto Before = Stream::Profiler::ThreadAllocations();
+        Func();
+        return Stream::Profiler::ThreadAllocations() - Before;
+    }
+
+    /// Integer key counting its hashes and equality comparisons, to bound the work of hash-based stages.
+    struct Probe
+    {
+        int Value = 0;
+
+        static inline std::uint64_t Comparisons = 0;
+        static inline std::uint64_t Hashes = 0;
+
+        static void Reset() { Comparisons = Hashes = 0; }
+
+        friend bool operator==(const Probe& Left, const Probe& Right)
+        {
+            ++Comparisons;
+            return Left.Value == Right.Value;
+        }
+    };
+
+    const auto Numbers = Stream::range(0, 99999).Collect();
+}
+
+template<>
+struct std::hash<Probe>
+{
+    std::size_t operator()(const Probe& Key) const noexcept
+    {
+        ++Probe::Hashes;
+        return std::hash<int>{}(Key.Value);
+    }
+};
+
+TEST(StreamAllocations, LazyStagesAllocateNothing)
+{
+    const auto Pipeline = [](){
+        return Stream::of(Numbers)
+            .Map([](int Value){ return Value * 3; })
+            .Filter([](int Value){ return Value % 2 == 0; })
+            .Reject([](int Value){ return Value % 7 == 0; })
+            .Each([](int){})
+            .Take(50000)
+            .Scan(0ll, [](long long Acc, int Value){ return Acc + Value; });
+    };
+
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Sum(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Sum(Stream::Summation::Kahan); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Count(42ll); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Reduce(0ll, [](long long Left, long long Right){ return Left ^ Right; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Stats(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Contains(-1ll); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().All([](long long Value){ return Value >= 0; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Any([](long long Value){ return Value < 0; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().None([](long long Value){ return Value < 0; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().Find([](long long Value){ return Value < 0; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().FindIndex([](long long Value){ return Value < 0; }); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().ForEach(Stream::counter()); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Pipeline().ApproxCountDistinct(); }), 0);
+
+    // Forward-range terminals over a random-access source
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).Map([](int Value){ return -Value; }).Min(); }), 0);
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).Map([](int Value){ return -Value; }).Max(); }), 0);
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).Map([](int Value){ return -Value; }).MinMax(); }), 0);
+}
+
+TEST(StreamAllocations, FusedAndErasedPipelinesAllocateNothing)
+{
+    const auto Map = [](int Value){ return Value + 1; };
+    const auto Even = [](int Value){ return Value % 2 == 0; };
+
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Fuse().Map(Map).Filter(Even).Sum(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Fuse().Map(Map).Filter(Even).Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Fuse().Filter(Even).Any([](int Value){ return Value > 50000; }); }), 0);
+
+    // Short pipelines fit the inline buffer of the erased stream, and pulling batches reuses its own storage
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Map(Map).Erase().Sum(); }), 0);
+}
+
+TEST(StreamAllocations, CombinatorsAllocateNothing)
+{
+    const auto Other = Stream::range(0, 99999).Map([](int Value){ return Value * 2; }).Collect();
+
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).ZipWith(std::plus{}, Other).Sum(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Zip(Other).Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Concat(Other).Sum(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Interleave(Other).Sum(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).WithIndex().Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).ChunkEvery(64).Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).ChunkWhile([](int Left, int Right){ return Right == Left + 1; }).Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Window(16).Count(); }), 0);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Tumbling(100, 0ll, std::plus{}).Sum(); }), 0);
+
+    // Splitting bytes copies the delimiter once per stage and nothing per piece
+    const auto Text = std::string(100000, 'x').replace(0, 1, ",").replace(5000, 1, ",").replace(70000, 1, ",");
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Text).SplitBy(',').Count(); }), 1);
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Text).SplitBy(',').Join().Count(); }), 1);
+}
+
+TEST(StreamAllocations, CollectAllocatesOnceWhenSized)
+{
+    EXPECT_EQ(AllocationsOf([]{ Stream::range(1, 100000).Collect(); }), 1);
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).Map([](int Value){ return Value * 0.5; }).Collect(); }), 1);
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).Take(1000).Collect(); }), 1);
+    EXPECT_EQ(AllocationsOf([]{ Stream::of(Numbers).ZipWith(std::plus{}, Numbers).Collect(); }), 1);
+
+    // Unsized views allocate once with a capacity hint, and grow geometrically without
+    const auto Even = [](int Value){ return Value % 2 == 0; };
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Filter(Even).Collect(Numbers.size()); }), 1);
+    EXPECT_LE(AllocationsOf([&]{ Stream::of(Numbers).Filter(Even).Collect(); }), std::bit_width(Numbers.size()) + 1);
+
+    // A reused buffer that already has room allocates nothing
+    auto Buffer = std::vector<int>{};
+    Buffer.reserve(Numbers.size());
+    EXPECT_EQ(AllocationsOf([&]{ Stream::of(Numbers).Filter(Even).CollectTo(Buffer); }), 0);
+    EXPECT_EQ(Buffer.size(), Numbers.size() / 2);
+
+    // Appending many small sized streams to one buffer grows it geometrically rather than once per append
+    auto Appended = std::vector<int>{};
+    const auto Appends = AllocationsOf([&]
+    {
+        for (auto Index = 0; Index < 10000; ++Index)
+            Stream::of(Numbers).Take(10).CollectTo(Appended);
+    });
+    EXPECT_EQ(Appended.size(), 100000);
+    EXPECT_LE(Appends, std::bit_width(Appended.size()));
+}
+
+TEST(StreamAllocations, StatefulStagesAllocateIndependentlyOfLength)
+{
+    // Stages that keep state allocate for their state, once or in a handful of geometric steps, never per element
+    const auto Bounded = [](auto Pipeline)
+    {
+        const auto Short = AllocationsOf([&]{ Pipeline(1000); });
+        const auto Long = AllocationsOf([&]{ Pipeline(1000000); });
+        EXPECT_EQ(Long, Short);
+        return Long;
+    };
+
+    const auto Modulo = [](int Size){ return Stream::of(std::views::iota(0, Size)).Map([](int Value){ return Value % 100; }); };
+    const auto Larger = [](int Left, int Right){ return std::max(Left, Right); };
+
+    EXPECT_EQ(Bounded([&](int Size){ Modulo(Size).Uniq(128).Count(); }), 1);
+    EXPECT_EQ(Bounded([&](int Size){ Modulo(Size).UniqBy([](int Value){ return Value / 10; }, 16).Count(); }), 1);
+    EXPECT_LE(Bounded([&](int Size){ Modulo(Size).Sliding(64, Larger).Sum(); }), 2 * (std::bit_width(64u) + 1));
+    EXPECT_LE(Bounded([&](int Size){ Modulo(Size).TopK(10); }), 2);
+    EXPECT_LE(Bounded([&](int Size){ Modulo(Size).Frequencies(); }), 16);
+    EXPECT_LE(Bounded([&](int Size){ Modulo(Size).ApproxTopK(5); }), 64);
+    EXPECT_LE(Bounded([&](int Size){ Stream::of(std::views::iota(0, Size)).Sort().Count(); }), 2);
+    EXPECT_LE(Bounded([&](int Size){ Stream::of(std::views::iota(0, Size)).Cache().Count(); }), 2);
+
+    // The quantile sketch adds a level, and the allocations filling it, each time the length grows by about 2x
+    const auto Quantiles = [&](int Size){ return AllocationsOf([&]{ Modulo(Size).ApproxQuantiles({0.5, 0.99}); }); };
+    EXPECT_LE(Quantiles(1000000), Quantiles(1000) + 16 * std::bit_width(1000u));
+}
+
+TEST(StreamComplexity, UniqIsLinear)
+{
+    // n = 1e5 with half of the keys repeated: the old Take(Index).Count(Value) scheme needed ~5e9 comparisons
+    auto Keys = std::vector<Probe>{};
+    for (auto Index = 0; Index < 100000; ++Index)
+        Keys.push_back({Index % 50000});
+
+    Probe::Reset();
+    EXPECT_EQ(Stream::of(Keys).Uniq().Count(), 50000);
+    EXPECT_LE(Probe::Comparisons, 3 * Keys.size());
+    EXPECT_LE(Probe::Hashes, 3 * Keys.size());
+
+    auto KeyCalls = std::size_t{0};
+    EXPECT_EQ(Stream::of(Keys).UniqBy([&](const Probe& Key){ ++KeyCalls; return Key.Value % 1000; }).Count(), 1000);
+    EXPECT_EQ(KeyCalls, Keys.size());
+}
+
+TEST(StreamComplexity, ForwardOnlyStagesMakeOnePass)
+{
+    // Every step over a Filter calls its predicate, so rescans from begin() show up as extra calls
+    const auto List = std::list<int>(Numbers.begin(), Numbers.end());
+    auto Calls = std::size_t{0};
+    const auto Counted = [&]{ return Stream::of(List).Filter([&](int){ ++Calls; return true; }); };
+
+    const auto Expect = [&](auto Result, auto Expected, std::size_t Passes = 1)
+    {
+        EXPECT_EQ(Result, Expected);
+        EXPECT_LE(Calls, Passes * List.size());
+        Calls = 0;
+    };
+
+    Expect(Counted().WithIndex().Count(), 100000);
+    Expect(Counted().ChunkEvery(7).Count(), 14286);
+
+    // These keep a cursor at each end of the current chunk or window, so each element is stepped over twice
+    Expect(Counted().ChunkWhile([](int Left, int Right){ return Right / 10 == Left / 10; }).Count(), 10000, 2);
+    Expect(Counted().Window(3).Count(), 99998, 2);
+    Expect(Counted().Uniq().Count(), 100000);
+    Expect(Counted().Tumbling(10, 0, std::plus{}).Count(), 10000);
+}
+
+TEST(StreamComplexity, ShortCircuitingTerminalsStopAtTheDecidingElement)
+{
+    auto Calls = std::size_t{0};
+    const auto Counted = [&](int Value){ ++Calls; return Value >= 10; };
+
+    EXPECT_TRUE(Stream::of(Numbers).Any(Counted));
+    EXPECT_EQ(std::exchange(Calls, 0), 11);
+    EXPECT_FALSE(Stream::of(Numbers).None(Counted));
+    EXPECT_EQ(std::exchange(Calls, 0), 11);
+    EXPECT_EQ(Stream::of(Numbers).FindIndex(Counted), 10);
+    EXPECT_EQ(std::exchange(Calls, 0), 11);
+    EXPECT_FALSE(Stream::of(Numbers).All([&](int Value){ return !Counted(Value); }));
+    EXPECT_EQ(std::exchange(Calls, 0), 11);
+
+    // Take over an unbounded source only pulls what it emits
+    EXPECT_EQ(Stream::of(std::views::iota(0)).Map([&](int Value){ ++Calls; return Value; }).Take(25).Sum(), 300);
+    EXPECT_EQ(Calls, 25);
+}
+
+TEST(StreamComplexity, OrderingStagesAreLinearithmic)
+{
+    auto Shuffled = Numbers;
+    std::ranges::shuffle(Shuffled, std::mt19937{7});
+    const auto Size = static_cast<double>(Shuffled.size());
+
+    auto Comparisons = std::size_t{0};
+    const auto Less = [&](int Left, int Right){ ++Comparisons; return Left < Right; };
+
+    EXPECT_EQ(Stream::of(Shuffled).Sort(Less).Take(3).Collect(), (std::vector{0, 1, 2}));
+    EXPECT_LE(static_cast<double>(std::exchange(Comparisons, 0)), 2.0 * Size * std::log2(Size));
+
+    // One comparison against the current K-th element for most of the input, and log K for the rest
+    EXPECT_EQ(Stream::of(Shuffled).TopK(5, [&](int Left, int Right){ return Less(Right, Left); }), (std::vector{99999, 99998, 99997, 99996, 99995}));
+    EXPECT_LE(static_cast<double>(std::exchange(Comparisons, 0)), 2.0 * Size);
+
+    auto KeyCalls = std::size_t{0};
+    const auto Groups = Stream::of(Shuffled).GroupBy([&](int Value){ ++KeyCalls; return Value % 16; });
+    EXPECT_EQ(Groups.size(), 16);
+    EXPECT_EQ(KeyCalls, Shuffled.size());
+}
+
+TEST(StreamComplexity, SlidingWindowsAreAmortizedConstant)
+{
+    // The two-stack queue folds each element a bounded number of times, whatever the window length
+    for (const auto Width : {std::size_t{4}, std::size_t{1000}})
+    {
+        auto Folds = std::size_t{0};
+        Stream::of(Numbers).Sliding(Width, [&](int Left, int Right){ ++Folds; return std::max(Left, Right); }).Count();
+        EXPECT_LE(Folds, 3 * Numbers.size()) << "window of " << Width;
+    }
+}